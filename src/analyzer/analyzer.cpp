@@ -1,9 +1,18 @@
 #include "analyzer.hpp"
 
+#include "disassembler.hpp"
 #include "exception-codes.hpp"
+#include "symbol-loader.hpp"
+#include "symbol-resolver.hpp"
+#include "symbol-service.hpp"
+#include "type-cache.hpp"
 #include "../utils/memory.hpp"
+#include "../utils/symbol-table.hpp"
 #include "../utils/utils.hpp"
+#include "../utils/config.hpp"
+#include "../utils/frame-compression.hpp"
 #include "../utils/geode-util.hpp"
+#include "../utils/thread-pool.hpp"
 
 #pragma comment(lib, "dbghelp")
 
@@ -14,31 +23,45 @@ namespace analyzer {
 
     static HANDLE s_mainThread = GetCurrentThread();
 
+    /// @brief Find the stack of the crashed thread.
+    /// @note The exception handler runs on the thread that crashed, so its TEB describes the right stack.
+    /// @return The stack pointer and the amount of values up to the stack base.
+    static std::pair<uintptr_t, size_t> findStack(const CONTEXT &context) {
+#ifndef _WIN64
+        uintptr_t stackPointer = context.Esp;
+#else
+        uintptr_t stackPointer = context.Rsp;
+#endif
+        stackPointer &= ~(sizeof(uintptr_t) - 1);
+
+        auto tib = reinterpret_cast<const NT_TIB *>(NtCurrentTeb());
+        auto stackBase = reinterpret_cast<uintptr_t>(tib->StackBase);
+        auto stackLimit = reinterpret_cast<uintptr_t>(tib->StackLimit);
+
+        // The stack pointer might be corrupted (or point to a fiber stack), so only scan what is readable then
+        size_t size;
+        if (stackPointer >= stackLimit && stackPointer < stackBase) {
+            size = utils::mem::getReadableSize(stackPointer, stackBase - stackPointer);
+        } else {
+            size = utils::mem::getReadableSize(stackPointer, Analyzer::STACK_PAGE_SIZE * sizeof(uintptr_t));
+        }
+
+        return {stackPointer, size / sizeof(uintptr_t)};
+    }
+
     void Analyzer::analyze(LPEXCEPTION_POINTERS info) {
         exceptionInfo = info;
 
-        // Get all module handles
-        if (modules.empty()) {
-            DWORD numModules;
-            HMODULE moduleHandles[1024];
-            if (EnumProcessModules(GetCurrentProcess(), moduleHandles, sizeof(moduleHandles), &numModules)) {
-                for (DWORD i = 0; i < numModules / sizeof(HMODULE); i++) {
-                    char buffer[MAX_PATH];
-                    GetModuleFileNameA(moduleHandles[i], buffer, MAX_PATH);
-                    MODULEINFO moduleInfo;
-                    GetModuleInformation(GetCurrentProcess(), moduleHandles[i], &moduleInfo, sizeof(moduleInfo));
-                    modules.push_back(
-                            {moduleHandles[i], utils::getFileName(buffer), buffer, (uintptr_t) moduleInfo.lpBaseOfDll,
-                             (uintptr_t) moduleInfo.SizeOfImage});
-                }
-            }
-        }
+        // Update the list of loaded modules
+        ModuleRegistry::get().refresh();
 
-        // Load debug symbols
-        if (!debugSymbolsLoaded) {
-            SymSetOptions(SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES | SYMOPT_UNDNAME);
-            debugSymbolsLoaded = SymInitialize(GetCurrentProcess(), nullptr, true);
-        }
+        // Snapshot the address space, so pointer checks don't need a syscall each
+        utils::mem::captureRegions();
+
+        std::tie(stackPointer, stackSize) = findStack(*info->ContextRecord);
+
+        // Modules are registered with DbgHelp only once an address lands in them
+        debugSymbolsLoaded = SymbolLoader::get().initialize();
 
         // Get thread ID and name
         if (threadInfo.empty()) {
@@ -63,20 +86,42 @@ namespace analyzer {
     }
 
     void Analyzer::cleanup() {
-        // Unload debug symbols
-        if (debugSymbolsLoaded) {
-            SymCleanup(GetCurrentProcess());
-        }
+        utils::mem::releaseRegions();
 
         // Reset all data
+        pointerGraph.clear();
         debugSymbolsLoaded = false;
         exceptionMessage.clear();
         registerStates.clear();
         cpuFlags.clear();
-        stackData.clear();
+        stackSize = 0;
+        {
+            std::lock_guard lock(stackPagesMutex);
+            stackPages.clear();
+        }
         stackAllocationsMessage.clear();
         stackTrace.clear();
         stackTraceMessage.clear();
+        stackWalkEnd = 0;
+        stackWalkTruncated = false;
+        probableFrames.clear();
+        probableFramesScanned = false;
+        probableFramesMessage.clear();
+        disasm::clearCallCache();
+        fingerprint = 0;
+        {
+            std::lock_guard lock(sourceLinesMutex);
+            sourceLines.clear();
+            sourceLinesGeneration++;
+        }
+
+        // Function and class names are only kept for one analysis, together with the caches pointing at them.
+        // Lookups that are still running are symbol service jobs, so none of them can see the arena being cleared.
+        SymbolService::get().call([] {
+            SymbolResolver::get().clear();
+            TypeCache::get().clear();
+            utils::getAnalysisArena().clear();
+        });
     }
 
     void Analyzer::reload() {
@@ -129,42 +174,25 @@ namespace analyzer {
         return exceptionMessage;
     }
 
-    bool hasTypeInfo(uintptr_t address) {
-        auto obj = reinterpret_cast<uintptr_t *>(address);
-        const char *type;
-        __try{
-                type = typeid(*obj).name();
-        }
-        __except(EXCEPTION_EXECUTE_HANDLER)
-        {
-            return false;
-        }
-
-        // check if it returned a valid string
-        if (!utils::mem::isStringPtr((uintptr_t) type)) {
-            return false;
-        }
-
-        // check if it starts with "class ", else return false
-        std::string typeStr(type);
-        if (typeStr.find("class ") != 0) {
-            return false;
-        }
-
-        return true;
-    }
-
     ValueType Analyzer::getValueType(uintptr_t address) {
         if (!utils::mem::isAccessible(address))
             return ValueType::Unknown;
 
-        if (utils::mem::isStringPtr(address))
+        // ASCII wide strings look like one-character strings, so prefer them over short narrow strings
+        auto length = utils::mem::getStringLength(address);
+        if (length && *length >= 2)
+            return ValueType::String;
+
+        if (utils::mem::isWideStringPtr(address))
+            return ValueType::WideString;
+
+        if (length)
             return ValueType::String;
 
         if (utils::mem::isFunctionPtr(address))
             return ValueType::Function;
 
-        if (hasTypeInfo(address))
+        if (TypeCache::get().getTypeName(address))
             return ValueType::CCObject;
 
         return ValueType::Pointer;
@@ -191,127 +219,26 @@ namespace analyzer {
     }
 
     MethodInfo Analyzer::getFunction(uintptr_t address) {
-        HMODULE module = utils::mem::getModuleHandle(address);
-        auto proc = GetCurrentProcess();
-
-        if (module == nullptr) {
-            // Check if it's a TulipHook hook handler
-            if (GeodeFunctionTableAccess64(proc, reinterpret_cast<DWORD64>(address))) {
-                MethodInfo info;
-                info.special = MethodInfo::Special::HookHandler;
-                info.address = address;
-                return info;
-            }
-
-            return {0, address};
-        }
-
-        auto moduleName = utils::mem::getModuleName(module);
-        auto moduleOffset = (uintptr_t) address - reinterpret_cast<uintptr_t>(module);
-
-        if (GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
-                              (LPCTSTR) address, &module)) {
-            static char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
-            auto pSymbol = (PSYMBOL_INFO) buffer;
-            pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
-            pSymbol->MaxNameLen = MAX_SYM_NAME;
-            DWORD64 displacement;
-            if (SymFromAddr(proc, (DWORD64) address, &displacement, pSymbol)) {
-                if (auto entry = SymFunctionTableAccess64(proc, static_cast<DWORD64>(address))) {
-                    auto moduleBase = SymGetModuleBase64(proc, static_cast<DWORD64>(address));
-                    auto runtimeFunction = static_cast<PRUNTIME_FUNCTION>(entry);
-                    auto unwindInfo = reinterpret_cast<PUNWIND_INFO>(moduleBase + runtimeFunction->UnwindInfoAddress);
-
-                    // This is a chain of unwind info structures, so we traverse back to the first one
-                    while (unwindInfo->Flags & UNW_FLAG_CHAININFO) {
-                        runtimeFunction = (PRUNTIME_FUNCTION) &(unwindInfo->UnwindCode[(unwindInfo->CountOfCodes + 1) &
-                                                                                       ~1]);
-                        unwindInfo = reinterpret_cast<PUNWIND_INFO>(moduleBase + runtimeFunction->UnwindInfoAddress);
-                    }
-
-                    if (moduleBase + runtimeFunction->BeginAddress != pSymbol->Address) {
-                        // the symbol address is not the same as the function address
-                        goto continueCheck; // :sob:
-                    }
-                }
-
-                return {moduleName, moduleOffset, pSymbol->Name, static_cast<uintptr_t>(displacement)};
-            }
-        }
-        continueCheck:
-
-        bool isMainModule = module == GetModuleHandle(nullptr);
-        bool isCocosModule = moduleName == "libcocos2d.dll";
-        if (isMainModule || isCocosModule) {
-            // Look up the function name in the CodegenData.txt file
-            auto methodInfo = utils::geode::getFunctionAddress(address, (uintptr_t) module, isCocosModule);
-            if (methodInfo.first != 0) {
-                auto methodOffset = moduleOffset - methodInfo.first;
-                auto methodName = methodInfo.second;
-                if (methodName.empty()) {
-                    return {moduleName, moduleOffset, fmt::format("<0x{:x}>", methodInfo.first), methodOffset};
-                }
-                return {moduleName, moduleOffset, methodName, methodOffset};
-            }
-
-            return {moduleName, moduleOffset, 0};
-        }
-
-        {
-            auto methodStart = utils::mem::findMethodStart(address);
-            if (methodStart == 0) {
-                return {moduleName, moduleOffset, 0};
-            }
-            auto methodOffset = (uintptr_t) address - methodStart;
-            methodStart -= (uintptr_t) module; // Get the offset from the module base
-            return {moduleName, moduleOffset, fmt::format("<0x{:x}>", methodStart), methodOffset};
-        }
+        return SymbolResolver::get().resolve(address);
     }
 
     std::string Analyzer::getString(uintptr_t address) {
-        const char *str = (const char *) address;
-        return fmt::format("&\"{}\"", str);
+        auto length = utils::mem::getStringLength(address).value_or(0);
+        return fmt::format("&\"{}\"", std::string_view((const char *) address, length));
     }
 
-    std::string Analyzer::getTypeName(uintptr_t address) {
-        auto *node = (uintptr_t *) address;
-#ifdef GEODE_IS_WINDOWS
-        const char *type = typeid(*node).name() + 6;
-#else
-        std::string type;
-        {
-            int status = 0;
-            auto demangle = abi::__cxa_demangle(typeid(*node).name(), 0, 0, &status);
-            if (status == 0) {
-                type = demangle;
-            }
-            free(demangle);
-        }
-#endif
-        return fmt::format("{}*", type);
+    std::string Analyzer::getWideString(uintptr_t address) {
+        auto length = utils::mem::getWideStringLength(address).value_or(0);
+        return fmt::format("&L\"{}\"", utils::mem::wideToUtf8((const char16_t *) address, length));
     }
 
-    std::string Analyzer::getFromPointer(uintptr_t address, size_t depth) {
-        uintptr_t value = *(uintptr_t *) address;
-
-        if (depth > 10) { // Prevent infinite recursion
-            return fmt::format("-> 0x{:X} [...]", value);
-        }
+    std::string Analyzer::getTypeName(uintptr_t address) {
+        auto type = TypeCache::get().getTypeName(address);
+        return fmt::format("{}*", type.value_or("<unknown>"));
+    }
 
-        // Check if this was a pointer to a pointer
-        auto valueType = getValueType(value);
-        switch (valueType) {
-            case ValueType::CCObject:
-                return fmt::format("-> 0x{:X} ({})", value, getTypeName(value));
-            case ValueType::Function:
-                return fmt::format("-> 0x{:X} -> {}", value, getFunction(value).toString());
-            case ValueType::String:
-                return fmt::format("-> 0x{:X} -> {}", value, getString(value));
-            case ValueType::Pointer:
-                return fmt::format("-> 0x{:X} {}", value, getFromPointer(value, depth + 1));
-            default:
-                return fmt::format("-> 0x{:X}", value);
-        }
+    std::string Analyzer::getFromPointer(uintptr_t address) {
+        return pointerGraph.describe(address);
     }
 
     std::pair<ValueType, std::string> Analyzer::getValue(uintptr_t address) {
@@ -320,6 +247,8 @@ namespace analyzer {
                 return {ValueType::Function, getFunction(address).toString()};
             case ValueType::String:
                 return {ValueType::String, getString(address)};
+            case ValueType::WideString:
+                return {ValueType::WideString, getWideString(address)};
             case ValueType::Pointer:
                 return {ValueType::Pointer, getFromPointer(address)};
             case ValueType::CCObject:
@@ -330,8 +259,15 @@ namespace analyzer {
     }
 
     RegisterState Analyzer::setupRegisterState(const std::string &name, uintptr_t value) {
-        auto valueResult = getValue(value);
-        return {name, value, valueResult.first, valueResult.second};
+        return {name, value, ValueType::Unknown, {}};
+    }
+
+    template <typename Slot>
+    void Analyzer::classifyValues(std::vector<Slot> &slots) {
+        utils::ThreadPool::get().parallelFor(slots.size(), [&](size_t i) {
+            auto &slot = slots[i];
+            std::tie(slot.type, slot.description) = getValue(slot.value);
+        });
     }
 
     const std::vector<RegisterState> &Analyzer::getRegisterStates() {
@@ -373,6 +309,7 @@ namespace analyzer {
                 setupRegisterState("RIP", context.Rip),
 #endif
         };
+        classifyValues(registerStates);
 
         return registerStates;
     }
@@ -487,41 +424,64 @@ namespace analyzer {
         return cpuFlags;
     }
 
-    const std::vector<StackLine> &Analyzer::getStackData() {
-        if (!stackData.empty())
-            return stackData;
+    size_t Analyzer::getStackSize() const {
+        return stackSize;
+    }
 
-        CONTEXT context = *exceptionInfo->ContextRecord;
-#ifndef _WIN64
-        uintptr_t stackPointer = context.Esp;
-#else
-        uintptr_t stackPointer = context.Rsp;
-#endif
-        constexpr int stackSize = -960;
-        constexpr int negativeStackSize = -1088;
-        for (int i = negativeStackSize; i < stackSize; i++) {
-            uintptr_t address = stackPointer + i * sizeof(uintptr_t);
-            if (!utils::mem::isAccessible(address)) {
-                geode::log::warn("Stack address 0x{:X} is not accessible", address);
-                break;
+    size_t Analyzer::getStackPageCount() const {
+        return (stackSize + STACK_PAGE_SIZE - 1) / STACK_PAGE_SIZE;
+    }
+
+    std::shared_ptr<const std::vector<StackLine>> Analyzer::getStackPage(size_t page) {
+        {
+            std::lock_guard lock(stackPagesMutex);
+            if (auto cached = stackPages.get(page)) {
+                return *cached;
             }
-            uintptr_t value = *(uintptr_t *) address;
-            auto valueResult = getValue(value);
-            stackData.push_back({address, value, valueResult.first, valueResult.second});
         }
 
-        return stackData;
+        auto lines = std::make_shared<std::vector<StackLine>>();
+        if (page < getStackPageCount()) {
+            auto first = page * STACK_PAGE_SIZE;
+            auto count = std::min(STACK_PAGE_SIZE, stackSize - first);
+            lines->reserve(count);
+            for (size_t i = first; i < first + count; i++) {
+                uintptr_t address = stackPointer + i * sizeof(uintptr_t);
+                uintptr_t value = *(uintptr_t *) address;
+                lines->push_back({address, value, ValueType::Unknown, {}});
+            }
+            classifyValues(*lines);
+        }
+
+        std::lock_guard lock(stackPagesMutex);
+        stackPages.put(page, lines);
+        return lines;
     }
 
     const std::string &Analyzer::getStackAllocationsMessage() {
         if (!stackAllocationsMessage.empty())
             return stackAllocationsMessage;
 
-        auto data = getStackData();
-        for (const auto &stackLine: data) {
+        auto depth = config::get().stack_depth > 0 ? config::get().stack_depth : DEFAULT_STACK_DEPTH;
+        depth = std::min<size_t>(depth, stackSize);
+
+        // Format page by page, so only one page is classified in memory at a time
+        for (size_t page = 0; page * STACK_PAGE_SIZE < depth; page++) {
+            auto lines = getStackPage(page);
+            auto count = std::min(lines->size(), depth - page * STACK_PAGE_SIZE);
+            for (size_t i = 0; i < count; i++) {
+                const auto &stackLine = (*lines)[i];
+                stackAllocationsMessage += fmt::format(
+                        "- 0x{:X}: {:08X} ({})\n",
+                        stackLine.address, stackLine.value, stackLine.description
+                );
+            }
+        }
+
+        if (depth < stackSize) {
             stackAllocationsMessage += fmt::format(
-                    "- 0x{:X}: {:08X} ({})\n",
-                    stackLine.address, stackLine.value, stackLine.description
+                    "- ... {} more values up to the stack base (0x{:X})\n",
+                    stackSize - depth, stackPointer + stackSize * sizeof(uintptr_t)
             );
         }
 
@@ -532,27 +492,137 @@ namespace analyzer {
         return stackAllocationsMessage;
     }
 
-    ModuleInfo *Analyzer::getModuleInfo(void *address) {
-        for (auto &module: modules) {
-            if (module.contains(address)) {
-                return &module;
-            }
-        }
-        return nullptr;
+    std::optional<ModuleInfo> Analyzer::getModuleInfo(void *address) {
+        return ModuleRegistry::get().find(reinterpret_cast<uintptr_t>(address));
     }
 
     PVOID CustomSymFunctionTableAccess64(HANDLE hProcess, DWORD64 AddrBase) {
         auto ret = GeodeFunctionTableAccess64(hProcess, AddrBase);
         if (ret) return ret;
+        SymbolLoader::get().load(static_cast<uintptr_t>(AddrBase));
         return SymFunctionTableAccess64(hProcess, AddrBase);
     }
 
     DWORD64 CustomSymGetModuleBase64(HANDLE hProcess, DWORD64 dwAddr) {
         auto ret = GeodeFunctionTableAccess64(hProcess, dwAddr);
         if (ret) return dwAddr & (~0xffffull);
+        SymbolLoader::get().load(static_cast<uintptr_t>(dwAddr));
         return SymGetModuleBase64(hProcess, dwAddr);
     }
 
+    StackTraceLine Analyzer::createStackTraceLine(uintptr_t address, uintptr_t framePointer) const {
+        StackTraceLine line{};
+        line.address = address;
+        line.framePointer = framePointer;
+        auto module = getModuleInfo((void *) address);
+        if (module) {
+            line.module = *module;
+            line.moduleOffset = address - (uintptr_t) module->handle;
+        }
+        return line;
+    }
+
+    void Analyzer::resolveFunctions(std::vector<StackTraceLine> &lines) {
+        std::vector<uintptr_t> addresses;
+        addresses.reserve(lines.size());
+        for (const auto &line: lines) {
+            addresses.push_back(line.address);
+        }
+
+        // One request for all frames, instead of a round trip to the symbol service per frame
+        auto functions = SymbolService::get().resolve(std::move(addresses)).get();
+        for (size_t i = 0; i < lines.size(); i++) {
+            lines[i].function = functions[i];
+        }
+    }
+
+    SourceLine Analyzer::getSourceLine(uintptr_t address, bool request) {
+        if (!debugSymbolsLoaded) {
+            return {SourceLineState::Resolved};
+        }
+
+        {
+            std::lock_guard lock(sourceLinesMutex);
+            if (auto it = sourceLines.find(address); it != sourceLines.end()) {
+                return it->second;
+            }
+            if (!request) {
+                return {};
+            }
+        }
+
+        requestSourceLines({address});
+        return {SourceLineState::Resolving};
+    }
+
+    std::future<void> Analyzer::requestSourceLines(std::vector<uintptr_t> addresses) {
+        uint32_t generation;
+        {
+            std::lock_guard lock(sourceLinesMutex);
+            generation = sourceLinesGeneration;
+            std::erase_if(addresses, [&](uintptr_t address) { return sourceLines.contains(address); });
+            for (auto address: addresses) {
+                sourceLines[address] = {SourceLineState::Resolving};
+            }
+        }
+
+        return SymbolService::get().submit([this, addresses = std::move(addresses), generation] {
+            for (auto address: addresses) {
+                auto info = SymbolResolver::get().resolve(address, true);
+
+                // Don't mix the lines into the results of a reloaded analyzer
+                std::lock_guard lock(sourceLinesMutex);
+                if (generation != sourceLinesGeneration) return;
+                sourceLines[address] = {SourceLineState::Resolved, info.file, info.line};
+            }
+        });
+    }
+
+    bool Analyzer::resolveSourceLines(const std::vector<StackTraceLine> &lines, std::chrono::milliseconds budget) {
+        if (!debugSymbolsLoaded) return true;
+
+        std::vector<uintptr_t> addresses;
+        addresses.reserve(lines.size());
+        for (const auto &line: lines) {
+            addresses.push_back(line.address);
+        }
+
+        // Requests are handled in order, so lines requested earlier are done by the time this one is
+        auto done = requestSourceLines(std::move(addresses));
+        return done.wait_for(budget) == std::future_status::ready;
+    }
+
+    /// @brief Format a stack trace line for the report.
+    static void appendStackTraceLine(std::string &message, const StackTraceLine &stackLine, const SourceLine &source) {
+        if (stackLine.function.module.empty()) {    // Likely a virtual function
+            if (stackLine.function.address == 0) {  // Function start not found
+                message += fmt::format("- 0x{:08X}\n", stackLine.function.offset);
+            } else {
+                message += fmt::format("- 0x{:08X}+0x{:x}\n", stackLine.function.address,
+                                       stackLine.function.offset);
+            }
+        } else if (stackLine.function.name.empty()) {
+            message += fmt::format("- {}+0x{:X}\n", stackLine.function.module, stackLine.moduleOffset);
+        } else {
+            message += fmt::format(
+                    "- {}+0x{:X} ({}+0x{:x})\n",
+                    stackLine.function.module, stackLine.function.address,
+                    stackLine.function.name, stackLine.function.offset);
+        }
+
+        if (!source.file.empty()) {
+            message += fmt::format("└ {}:{}\n", source.file, source.line);
+        }
+
+        if (stackLine.repeatCount > 0) {
+            message += fmt::format("└ last {} frame(s) repeated {} more times\n", stackLine.repeatLength, stackLine.repeatCount);
+        }
+
+        if (stackLine.skippedFrames > 0) {
+            message += fmt::format("- ... {} frames omitted\n", stackLine.skippedFrames);
+        }
+    }
+
     const std::vector<StackTraceLine> &Analyzer::getStackTrace() {
         if (!stackTrace.empty())
             return stackTrace;
@@ -577,69 +647,95 @@ namespace analyzer {
         stackFrame.AddrStack.Offset = ctx->Esp;
 #endif
 
+        // The walk runs on the symbol service thread, which needs a real handle to this thread
         HANDLE process = GetCurrentProcess();
-        HANDLE thread = GetCurrentThread();
-
-        while (StackWalk64(machineType, process, thread, &stackFrame, ctx, nullptr,
-                           CustomSymFunctionTableAccess64, CustomSymGetModuleBase64, nullptr)) {
-            if (stackFrame.AddrPC.Offset == 0) {
-                break;
-            }
-            StackTraceLine line{};
-            line.address = stackFrame.AddrPC.Offset;
-            line.function = getFunction(stackFrame.AddrPC.Offset);
-            line.framePointer = stackFrame.AddrFrame.Offset;
-            auto module = getModuleInfo((void *) stackFrame.AddrPC.Offset);
-            if (module) {
-                line.module = *module;
-                line.moduleOffset = stackFrame.AddrPC.Offset - (uintptr_t) module->handle;
-            }
+        HANDLE thread = nullptr;
+        if (!DuplicateHandle(process, GetCurrentThread(), process, &thread, 0, FALSE, DUPLICATE_SAME_ACCESS)) {
+            thread = nullptr;
+        }
+
+        // Only collect the addresses while walking, symbols are resolved for the frames that are kept
+        std::vector<utils::RawFrame> frames;
+        SymbolService::get().call([&] {
+            while (frames.size() < MAX_STACK_WALK) {
+                if (!StackWalk64(machineType, process, thread, &stackFrame, ctx, nullptr,
+                                 CustomSymFunctionTableAccess64, CustomSymGetModuleBase64, nullptr)) {
+                    break;
+                }
 
-            if (debugSymbolsLoaded) {
-                DWORD displacement;
-                IMAGEHLP_LINE64 lineInfo;
-                lineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
-                if (SymGetLineFromAddr64(process, stackFrame.AddrPC.Offset, &displacement, &lineInfo)) {
-                    line.function.file = lineInfo.FileName;
-                    line.function.line = lineInfo.LineNumber;
+                if (stackFrame.AddrPC.Offset == 0) {
+                    break;
                 }
+                frames.push_back({stackFrame.AddrPC.Offset, stackFrame.AddrFrame.Offset});
+                stackWalkEnd = stackFrame.AddrStack.Offset;
             }
+        });
+        stackWalkTruncated = frames.size() == MAX_STACK_WALK;
 
-            stackTrace.push_back(line);
+        if (thread) {
+            CloseHandle(thread);
         }
 
+        // Long traces are shortened to their first and last lines, the middle is usually more of the same
+        auto runs = utils::compressFrames(frames);
+        for (const auto &kept: utils::selectFrames(runs)) {
+            const auto &frame = frames[kept.index];
+            auto &line = stackTrace.emplace_back(createStackTraceLine(frame.address, frame.framePointer));
+            line.repeatLength = kept.repeatLength;
+            line.repeatCount = kept.repeatCount;
+            line.skippedFrames = kept.skippedFrames;
+        }
+
+        resolveFunctions(stackTrace);
         return stackTrace;
     }
 
+    const std::vector<StackTraceLine> &Analyzer::getProbableFrames() {
+        if (probableFramesScanned)
+            return probableFrames;
+        probableFramesScanned = true;
+
+        const auto &trace = getStackTrace();
+
+        // Continue where StackWalk64 gave up
+        size_t first = stackWalkEnd > stackPointer ? (stackWalkEnd - stackPointer) / sizeof(uintptr_t) : 0;
+        for (size_t i = first; i < stackSize && probableFrames.size() < MAX_PROBABLE_FRAMES; i++) {
+            uintptr_t slot = stackPointer + i * sizeof(uintptr_t);
+            uintptr_t value = *(uintptr_t *) slot;
+
+            // Cheap checks first, decoding the preceding bytes is the most expensive part
+            if (!utils::mem::isFunctionPtr(value) || !ModuleRegistry::get().find(value)) continue;
+            if (!disasm::followsCall(value)) continue;
+
+            auto known = std::any_of(trace.begin(), trace.end(), [&](const StackTraceLine &line) {
+                return line.address == value;
+            });
+            if (known) continue;
+
+            probableFrames.push_back(createStackTraceLine(value, slot));
+        }
+
+        resolveFunctions(probableFrames);
+        return probableFrames;
+    }
+
     const std::string &Analyzer::getStackTraceMessage() {
         if (!stackTraceMessage.empty())
             return stackTraceMessage;
 
-        auto data = getStackTrace();
+        const auto &data = getStackTrace();
+        auto linesResolved = resolveSourceLines(data, SOURCE_LINE_BUDGET);
 
         for (const auto &stackLine: data) {
-            if (stackLine.function.module.empty()) {    // Likely a virtual function
-                if (stackLine.function.address == 0) {  // Function start not found
-                    stackTraceMessage += fmt::format("- 0x{:08X}\n", stackLine.function.offset);
-                } else {
-                    stackTraceMessage += fmt::format("- 0x{:08X}+0x{:x}\n", stackLine.function.address,
-                                                     stackLine.function.offset);
-                }
-                continue;
-            }
+            appendStackTraceLine(stackTraceMessage, stackLine, getSourceLine(stackLine.address, false));
+        }
 
-            if (stackLine.function.name.empty()) {
-                stackTraceMessage += fmt::format("- {}+0x{:X}\n", stackLine.function.module, stackLine.moduleOffset);
-            } else {
-                stackTraceMessage += fmt::format(
-                        "- {}+0x{:X} ({}+0x{:x})\n",
-                        stackLine.function.module, stackLine.function.address,
-                        stackLine.function.name, stackLine.function.offset);
-            }
+        if (!linesResolved) {
+            stackTraceMessage += "- (source lines of some frames were skipped, loading them took too long)\n";
+        }
 
-            if (!stackLine.function.file.empty()) {
-                stackTraceMessage += fmt::format("└ {}:{}\n", stackLine.function.file, stackLine.function.line);
-            }
+        if (stackWalkTruncated) {
+            stackTraceMessage += fmt::format("- ... stopped after {} frames\n", MAX_STACK_WALK);
         }
 
         if (!stackTraceMessage.empty()) {
@@ -649,6 +745,23 @@ namespace analyzer {
         return stackTraceMessage;
     }
 
+    const std::string &Analyzer::getProbableFramesMessage() {
+        if (!probableFramesMessage.empty())
+            return probableFramesMessage;
+
+        const auto &data = getProbableFrames();
+
+        for (const auto &stackLine: data) {
+            appendStackTraceLine(probableFramesMessage, stackLine, getSourceLine(stackLine.address, false));
+        }
+
+        if (!probableFramesMessage.empty()) {
+            probableFramesMessage.pop_back();
+        }
+
+        return probableFramesMessage;
+    }
+
     bool Analyzer::isGraphicsDriverCrash() {
         const std::array<std::string, 7> graphicsDrivers = {
                 "nvoglv32.dll", // NVIDIA
@@ -662,11 +775,11 @@ namespace analyzer {
         };
 
         // check latest 3 stack frames
-        auto trace = getStackTrace();
+        const auto &trace = getStackTrace();
         for (int i = 0; i < 3 && i < trace.size(); i++) {
             auto &line = trace[i];
             for (const auto &driver: graphicsDrivers) {
-                if (line.module.name.find(driver) != std::string::npos) {
+                if (line.module.name.find(driver) != std::string_view::npos) {
                     return true;
                 }
             }
@@ -674,6 +787,55 @@ namespace analyzer {
         return false;
     }
 
+    /// @brief Check if the module is a part of Windows, so its frames say little about the cause of a crash.
+    static bool isSystemModule(const ModuleInfo &module) {
+        static const std::string windowsDir = [] {
+            char buffer[MAX_PATH];
+            auto length = GetWindowsDirectoryA(buffer, MAX_PATH);
+            return std::string(buffer, length < MAX_PATH ? length : 0);
+        }();
+
+        if (windowsDir.empty() || module.path.size() < windowsDir.size()) return false;
+        return _strnicmp(module.path.data(), windowsDir.data(), windowsDir.size()) == 0;
+    }
+
+    uint64_t Analyzer::getFingerprint() {
+        if (fingerprint != 0)
+            return fingerprint;
+
+        std::string key = fmt::format("{:08X}", exceptionInfo->ExceptionRecord->ExceptionCode);
+        size_t frames = 0;
+        for (const auto &line: getStackTrace()) {
+            if (frames == FINGERPRINT_FRAMES) break;
+
+            // Hook handlers and code outside of modules are at different addresses every run
+            if (line.function.isHookHandler() || line.module.name.empty() || isSystemModule(line.module)) continue;
+
+            std::string module(line.module.name);
+            std::transform(module.begin(), module.end(), module.begin(), [](unsigned char c) {
+                return static_cast<char>(std::tolower(c));
+            });
+
+            if (!line.function.name.empty()) {
+                key += fmt::format("|{}!{}", module, line.function.name);
+            } else {
+                key += fmt::format("|{}+0x{:X}", module, line.moduleOffset);
+            }
+            frames++;
+        }
+
+        fingerprint = utils::SymbolTable::hash(key);
+        if (fingerprint == 0) fingerprint = 1;
+        return fingerprint;
+    }
+
+    std::string Analyzer::getDiagnosticsMessage() {
+        return fmt::format(
+                "{}\n{}\n- Pointer graph: {} addresses",
+                SymbolResolver::get().getStatsMessage(), SymbolLoader::get().getStatsMessage(), pointerGraph.size()
+        );
+    }
+
     bool Analyzer::isMainThread() const {
         return mainThreadCrash;
     }
@@ -6,21 +6,21 @@
 #include <vector>
 #include <map>
 #include <array>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
-namespace analyzer {
-
-    struct ModuleInfo {
-        HMODULE handle;
-        std::string name;
-        std::string path;
-        uintptr_t baseAddress;
-        uintptr_t size;
+#include "module-registry.hpp"
+#include "pointer-graph.hpp"
+#include "../utils/lru-cache.hpp"
+#include "../utils/string-arena.hpp"
 
-        [[nodiscard]] bool contains(void *address) const {
-            return address >= (void *) baseAddress && address < (void *) (baseAddress + size);
-        }
-    };
+namespace analyzer {
 
     enum class ValueType {
         // Unknown type
@@ -31,22 +31,25 @@ namespace analyzer {
         Function,
         // A valid string pointer
         String,
+        // A valid wide (UTF-16) string pointer
+        WideString,
         // A valid CCObject pointer
         CCObject,
     };
 
+    /// @note All strings are interned (see utils::intern and utils::internSymbol), so the struct is cheap to copy.
     struct MethodInfo {
         enum class Special {
             None = 0,
             HookHandler = 1,
         };
 
-        std::string module; // Module name
+        std::string_view module; // Module name
         uintptr_t address; // Address, relative to the module
-        std::string name; // Function name
+        std::string_view name; // Function name
         uintptr_t offset; // Offset from the function start
 
-        std::string file; // File name (if available)
+        std::string_view file; // File name (if available)
         uint32_t line; // Line number (if available)
         Special special = Special::None;
 
@@ -58,12 +61,12 @@ namespace analyzer {
                 : address(addr), offset(offset), line(0) {}
 
         /// @brief Constructor with module.
-        MethodInfo(std::string mod, uintptr_t addr, uintptr_t offset)
-                : module(std::move(mod)), address(addr), offset(offset), line(0) {}
+        MethodInfo(std::string_view mod, uintptr_t addr, uintptr_t offset)
+                : module(utils::intern(mod)), address(addr), offset(offset), line(0) {}
 
         /// @brief Constructor with module and function name.
-        MethodInfo(std::string mod, uintptr_t addr, std::string nm, uintptr_t offset)
-                : module(std::move(mod)), address(addr), name(std::move(nm)), offset(offset), line(0) {}
+        MethodInfo(std::string_view mod, uintptr_t addr, std::string_view nm, uintptr_t offset)
+                : module(utils::intern(mod)), address(addr), name(utils::internSymbol(nm)), offset(offset), line(0) {}
 
         [[nodiscard]] bool isHookHandler() const {
             return (static_cast<int>(special) & static_cast<int>(Special::HookHandler)) != 0;
@@ -94,6 +97,22 @@ namespace analyzer {
         uintptr_t moduleOffset{}; // Offset from the module base
         MethodInfo function; // Function information
         uintptr_t framePointer{}; // Stack frame pointer
+        size_t repeatLength{}; // Length of the cycle ending with this frame (recursion), or 0
+        size_t repeatCount{}; // How many more times the cycle was repeated
+        size_t skippedFrames{}; // Amount of frames omitted after this one, to keep the trace short
+    };
+
+    /// @brief Progress of the source line lookup of a frame.
+    enum class SourceLineState {
+        Unresolved, // Not requested yet
+        Resolving, // Being looked up in the background
+        Resolved, // Done (the file might still be unknown)
+    };
+
+    struct SourceLine {
+        SourceLineState state = SourceLineState::Unresolved;
+        std::string_view file; // File name (interned)
+        uint32_t line = 0;
     };
 
     struct XmmRegister {
@@ -111,20 +130,61 @@ namespace analyzer {
     private:
         LPEXCEPTION_POINTERS exceptionInfo = nullptr;
         std::string threadInfo;
-        std::vector<ModuleInfo> modules;
         bool debugSymbolsLoaded = false;
 
         std::string exceptionMessage;
         std::vector<RegisterState> registerStates;
         std::map<std::string, bool> cpuFlags;
         std::vector<XmmRegister> xmmRegisters;
-        std::vector<StackLine> stackData;
+        uintptr_t stackPointer = 0; // Start of the stack scan
+        size_t stackSize = 0; // Amount of values between the stack pointer and the stack base
+        std::mutex stackPagesMutex;
+        utils::LruCache<size_t, std::shared_ptr<const std::vector<StackLine>>> stackPages;
         std::string stackAllocationsMessage;
         std::vector<StackTraceLine> stackTrace;
         std::string stackTraceMessage;
+        uintptr_t stackWalkEnd = 0; // Stack pointer of the last frame StackWalk64 unwound
+        bool stackWalkTruncated = false; // The walk stopped at MAX_STACK_WALK frames
+        std::vector<StackTraceLine> probableFrames;
+        bool probableFramesScanned = false;
+        std::string probableFramesMessage;
+        uint64_t fingerprint = 0;
+
+        std::mutex sourceLinesMutex;
+        std::unordered_map<uintptr_t, SourceLine> sourceLines;
+        uint32_t sourceLinesGeneration = 0; // Incremented on cleanup, so late results are dropped
+
+        /// @brief Look up the source lines on the symbol service thread.
+        /// Addresses that were already requested are skipped.
+        /// @return Future that is ready once all lines of this request are resolved.
+        std::future<void> requestSourceLines(std::vector<uintptr_t> addresses);
         std::string registerStateMessage;
+        PointerGraph pointerGraph;
         bool mainThreadCrash = false;
+
     public:
+        /// @brief Amount of values in a page of the stack (one memory page).
+        static constexpr size_t STACK_PAGE_SIZE = 0x1000 / sizeof(uintptr_t);
+
+        /// @brief Amount of classified stack pages kept in memory.
+        static constexpr size_t STACK_PAGE_CACHE = 8;
+
+        /// @brief Amount of stack values included in the report when the config doesn't specify it.
+        static constexpr size_t DEFAULT_STACK_DEPTH = 256;
+
+        /// @brief Maximum amount of frames walked by StackWalk64 (stack overflows can have tens of thousands).
+        static constexpr size_t MAX_STACK_WALK = 0x10000;
+
+        /// @brief Time the report may spend on looking up source lines (loading line tables can be slow).
+        static constexpr std::chrono::milliseconds SOURCE_LINE_BUDGET{2000};
+
+        /// @brief Amount of frames used for the crash fingerprint.
+        static constexpr size_t FINGERPRINT_FRAMES = 5;
+
+        /// @brief Maximum amount of frames found by scanning the stack.
+        static constexpr size_t MAX_PROBABLE_FRAMES = 32;
+
+        Analyzer() : stackPages(STACK_PAGE_CACHE) {}
 
         /// @brief Analyze the exception information.
         void analyze(LPEXCEPTION_POINTERS info);
@@ -144,11 +204,14 @@ namespace analyzer {
         /// @brief Get the string from an address.
         static std::string getString(uintptr_t address);
 
+        /// @brief Get the wide string from an address, converted to UTF-8.
+        static std::string getWideString(uintptr_t address);
+
         /// @brief Get the name of a CCObject from an address.
         static std::string getTypeName(uintptr_t address);
 
-        /// @brief Get the string from a pointer.
-        std::string getFromPointer(uintptr_t address, size_t depth = 0);
+        /// @brief Get the chain of pointers starting at an address.
+        std::string getFromPointer(uintptr_t address);
 
         /// @brief Deduce the value from a pointer.
         std::pair<ValueType, std::string> getValue(uintptr_t address);
@@ -159,8 +222,14 @@ namespace analyzer {
         const std::string &getExceptionMessage();
 
         /// @brief Constructs a register state.
+        /// @note The value is not classified yet, see `classifyValues`.
         RegisterState setupRegisterState(const std::string &name, uintptr_t value);
 
+        /// @brief Classify the values of the slots on the worker pool.
+        /// Each slot is written by a single task, so no synchronization is needed.
+        template <typename Slot>
+        void classifyValues(std::vector<Slot> &slots);
+
         /// @brief Get register states.
         /// @note This function should be called after the analyze function.
         /// @return The register states that can be displayed to the user.
@@ -181,10 +250,18 @@ namespace analyzer {
         /// @return The register state message that can be displayed to the user.
         const std::string &getRegisterStateMessage();
 
-        /// @brief Get the stack allocated data. (Latest 32 entries)
+        /// @brief Get the amount of values on the stack, from the stack pointer up to the stack base.
+        /// @note This function should be called after the analyze function.
+        size_t getStackSize() const;
+
+        /// @brief Get the amount of pages of the stack.
+        size_t getStackPageCount() const;
+
+        /// @brief Get a page of the stack, counting from the stack pointer.
+        /// Values are classified the first time the page is requested, and only a few pages are kept in memory.
         /// @note This function should be called after the analyze function.
-        /// @return The stack data that can be displayed to the user.
-        const std::vector<StackLine> &getStackData();
+        /// @return The stack data that can be displayed to the user (empty if the page is out of range).
+        std::shared_ptr<const std::vector<StackLine>> getStackPage(size_t page);
 
         /// @brief Get the information about the stack allocations.
         const std::string &getStackAllocationsMessage();
@@ -194,16 +271,55 @@ namespace analyzer {
         /// @return The stack trace that can be displayed to the user.
         const std::vector<StackTraceLine> &getStackTrace();
 
+        /// @brief Find the module of a frame. The function is filled in by `resolveFunctions`.
+        StackTraceLine createStackTraceLine(uintptr_t address, uintptr_t framePointer) const;
+
+        /// @brief Resolve the functions of all frames in a single symbol service request.
+        static void resolveFunctions(std::vector<StackTraceLine> &lines);
+
+        /// @brief Get the source file and line of a frame.
+        /// Line tables are loaded on demand by DbgHelp, which can take a while, so the lookup doesn't block:
+        /// the first call queues it, and returns `SourceLineState::Resolving` until it is done.
+        /// @param address The address of the frame
+        /// @param request Whether to start the lookup if it wasn't requested yet
+        SourceLine getSourceLine(uintptr_t address, bool request = true);
+
+        /// @brief Request the source lines of all frames at once, and wait for them until the time budget runs out.
+        /// Lines that take longer are still filled in afterwards.
+        /// @return Whether all lines were resolved in time.
+        bool resolveSourceLines(const std::vector<StackTraceLine> &lines, std::chrono::milliseconds budget);
+
         /// @brief Get the stack trace message.
         /// @note This function should be called after the analyze function.
         /// @return The stack trace message that can be displayed to the user.
         const std::string &getStackTraceMessage();
 
+        /// @brief Get the frames found by scanning the stack for return addresses.
+        /// Only the part of the stack that StackWalk64 couldn't unwind is scanned, and every candidate
+        /// has to follow a call instruction, but the frames might still be stale values.
+        /// @note This function should be called after the analyze function.
+        /// @return The probable frames, from the top of the stack.
+        const std::vector<StackTraceLine> &getProbableFrames();
+
+        /// @brief Get the probable frames message.
+        /// @return The message, or an empty string if there are no probable frames.
+        const std::string &getProbableFramesMessage();
+
+        /// @brief Get a fingerprint of the crash, which stays the same for crashes with the same cause.
+        /// Built from the exception code and the top frames outside of Windows modules and hook handlers.
+        /// @note This function should be called after the analyze function.
+        /// @return The fingerprint (never 0).
+        uint64_t getFingerprint();
+
+        /// @brief Get the diagnostics message (symbol provider statistics etc.)
+        /// @note Not cached, so it should be called after everything else is resolved.
+        std::string getDiagnosticsMessage();
+
         /// @brief Check if the graphics driver crashed. (stack trace contains GPU driver dll)
         bool isGraphicsDriverCrash();
 
         /// @brief Get the module information from an address.
-        ModuleInfo *getModuleInfo(void *address);
+        static std::optional<ModuleInfo> getModuleInfo(void *address);
 
         /// @brief Check whether the crash happened in the main thread
         bool isMainThread() const;
@@ -1,9 +1,10 @@
 #include "disassembler.hpp"
 
 #include <Zydis/Zydis.h>
-#include <fmt/format.h>
-#include <sstream>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdio>
+
+#include "../utils/memory.hpp"
 
 #ifdef _WIN32
 #ifdef _WIN64
@@ -23,45 +24,116 @@ namespace disasm {
     static ZydisDecoder decoder;
     static ZydisFormatter formatter;
 
-    std::unordered_map<uintptr_t, Instruction> cache;
+    /// @brief Amount of cached instructions (a power of two).
+    static constexpr size_t CACHE_SIZE = 4096;
+
+    /// @brief Direct-mapped cache, an address can only be stored in one slot.
+    static std::array<Instruction, CACHE_SIZE> cache;
+
+    /// @brief Result of `followsCall` for an address.
+    struct CallSite {
+        uintptr_t address = 0;
+        bool followsCall = false;
+    };
+
+    /// @brief Direct-mapped like the instruction cache, so probing a deep stack doesn't grow it.
+    static std::array<CallSite, CACHE_SIZE> callCache;
+
+    /// @brief Longest encoding of a near call (e.g. `call qword ptr [r12+disp32]`).
+    static constexpr size_t MAX_CALL_LENGTH = 8;
+
+    /// @brief Initialize the decoder and the formatter on first use.
+    /// @return Whether Zydis is ready.
+    static bool initialize() {
+        static bool ready = ZYAN_SUCCESS(ZydisDecoderInit(&decoder, TARGET_ARCH, TARGET_ADDR_WIDTH))
+                            && ZYAN_SUCCESS(ZydisFormatterInit(&formatter, ZYDIS_FORMATTER_STYLE_INTEL));
+        return ready;
+    }
+
+    static size_t getCacheSlot(uintptr_t address) {
+        return (address ^ (address >> 12)) & (CACHE_SIZE - 1);
+    }
+
+    void Instruction::formatBytes(char *buffer, size_t bufferSize) const {
+        constexpr char digits[] = "0123456789ABCDEF";
 
-    const Instruction& disassemble(uintptr_t address) {
-        if (cache.find(address) != cache.end()) {
-            return cache[address];
+        size_t length = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (length + (i > 0 ? 4 : 3) > bufferSize) break; // Separator, two digits and the terminator
+            if (i > 0) buffer[length++] = ' ';
+            buffer[length++] = digits[bytes[i] >> 4];
+            buffer[length++] = digits[bytes[i] & 0xF];
         }
+        if (bufferSize > 0) buffer[length] = '\0';
+    }
 
-        Instruction instruction;
-        instruction.address = address;
+    void Instruction::formatText(char *buffer, size_t bufferSize) const {
+        if (bufferSize == 0) return;
 
-        ZyanUSize offset = 0;
-        ZydisDisassembledInstruction ins;
-        while (ZYAN_SUCCESS(ZydisDisassembleIntel(
-                /* machine_mode:    */ TARGET_ARCH,
-                /* runtime_address: */ address,
-                /* buffer:          */ reinterpret_cast<const void *>(address + offset),
-                /* length:          */ 16 - offset,
-                /* instruction:     */ &ins
+        ZydisDecodedInstruction ins;
+        ZydisDecodedOperand operands[ZYDIS_MAX_OPERAND_COUNT];
+        if (size == 0 || !initialize()
+            || !ZYAN_SUCCESS(ZydisDecoderDecodeFull(&decoder, bytes.data(), size, &ins, operands))
+            || !ZYAN_SUCCESS(ZydisFormatterFormatInstruction(
+                &formatter, &ins, operands, ins.operand_count_visible, buffer, bufferSize, address, nullptr
         ))) {
-            instruction.text = ins.text;
-            instruction.size = ins.info.length;
+            std::snprintf(buffer, bufferSize, "(bad)");
+        }
+    }
+
+    Instruction disassemble(uintptr_t address) {
+        auto &slot = cache[getCacheSlot(address)];
+        if (slot.address == address && address != 0) {
+            return slot;
+        }
 
-            // Get the bytes
-            std::vector<uint8_t> bytes(ins.info.length);
-            for (int i = 0; i < ins.info.length; i++) {
-                bytes[i] = *(reinterpret_cast<uint8_t *>(address + offset + i));
+        Instruction instruction;
+        instruction.address = address;
+
+        // Only copy what can be read, the instruction might end right before an unmapped page
+        auto readable = utils::mem::getReadableSize(address, MAX_INSTRUCTION_LENGTH);
+        if (readable > 0 && initialize()) {
+            ZydisDecodedInstruction ins;
+            if (utils::mem::readMemory(address, instruction.bytes.data(), readable) && ZYAN_SUCCESS(
+                    ZydisDecoderDecodeInstruction(&decoder, nullptr, instruction.bytes.data(), readable, &ins))) {
+                instruction.size = ins.length;
             }
+        }
 
-            // Convert to hex string
-            std::stringstream ss;
-            for (const auto& byte : bytes) {
-                ss << fmt::format("{:02X} ", byte);
+        // Keep only the bytes of the instruction
+        std::fill(instruction.bytes.begin() + instruction.size, instruction.bytes.end(), 0);
+
+        slot = instruction;
+        return instruction;
+    }
+
+    bool followsCall(uintptr_t address) {
+        auto &slot = callCache[getCacheSlot(address)];
+        if (slot.address == address && address != 0) {
+            return slot.followsCall;
+        }
+
+        // Read the bytes once, then try every possible call length ending at the address
+        bool result = false;
+        uint8_t buffer[MAX_CALL_LENGTH];
+        if (initialize() && address > MAX_CALL_LENGTH
+            && utils::mem::getReadableSize(address - MAX_CALL_LENGTH, MAX_CALL_LENGTH) == MAX_CALL_LENGTH
+            && utils::mem::readMemory(address - MAX_CALL_LENGTH, buffer, MAX_CALL_LENGTH)) {
+            for (size_t length = 2; length <= MAX_CALL_LENGTH && !result; length++) {
+                ZydisDecodedInstruction ins;
+                auto status = ZydisDecoderDecodeInstruction(
+                        &decoder, nullptr, buffer + MAX_CALL_LENGTH - length, length, &ins
+                );
+                result = ZYAN_SUCCESS(status) && ins.length == length && ins.mnemonic == ZYDIS_MNEMONIC_CALL;
             }
-            instruction.bytes = ss.str().substr(0, ss.str().size() - 1);
-            break;
         }
 
-        cache[address] = instruction;
-        return cache[address];
+        slot = {address, result};
+        return result;
+    }
+
+    void clearCallCache() {
+        callCache.fill({});
     }
 
     std::vector<Instruction> disassemble(uintptr_t start, uintptr_t end) {
@@ -69,7 +141,7 @@ namespace disasm {
         for (uintptr_t i = start; i <= end;) {
             auto ins = disassemble(i);
             instructions.push_back(ins);
-            i += ins.size;
+            i += ins.size > 0 ? ins.size : 1; // Skip undecodable bytes one at a time
         }
         return instructions;
     }
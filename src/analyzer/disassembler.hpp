@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -7,24 +8,50 @@
 
 namespace disasm {
 
+    /// @brief Longest possible x86 instruction.
+    static constexpr size_t MAX_INSTRUCTION_LENGTH = 15;
+
+    /// @brief Buffer size for `Instruction::formatBytes` ("XX " per byte).
+    static constexpr size_t BYTES_TEXT_SIZE = MAX_INSTRUCTION_LENGTH * 3;
+
+    /// @brief Buffer size for `Instruction::formatText`.
+    static constexpr size_t INSTRUCTION_TEXT_SIZE = 96;
+
+    /// @brief A decoded instruction, stored as its raw bytes.
+    /// The hex dump and the assembly text are only formatted when they are displayed.
     struct Instruction {
-        std::string bytes;
-        std::string text;
-        uintptr_t address;
-        size_t size;
+        uintptr_t address = 0;
+        std::array<uint8_t, MAX_INSTRUCTION_LENGTH> bytes{};
+        uint8_t size = 0; // 0 if the instruction couldn't be decoded
+
+        /// @brief Write the bytes as hex (e.g. "48 8B 05") into the buffer.
+        void formatBytes(char *buffer, size_t bufferSize) const;
+
+        /// @brief Write the assembly text (e.g. "mov rax, [rbx]") into the buffer.
+        void formatText(char *buffer, size_t bufferSize) const;
 
-        Instruction() : address(0) {}
+        [[nodiscard]] std::string getBytes() const {
+            char buffer[BYTES_TEXT_SIZE];
+            formatBytes(buffer, sizeof(buffer));
+            return buffer;
+        }
+
+        [[nodiscard]] std::string getText() const {
+            char buffer[INSTRUCTION_TEXT_SIZE];
+            formatText(buffer, sizeof(buffer));
+            return buffer;
+        }
 
         [[nodiscard]] std::string toString() const {
-            return fmt::format("{:08X} | {} | {}", address, bytes, text);
+            return fmt::format("{:08X} | {} | {}", address, getBytes(), getText());
         }
     };
 
     /// @brief Get an instruction from a given address.
     /// @param address The address to disassemble.
     /// @return The disassembled instruction.
-    /// @note The result is cached.
-    const Instruction& disassemble(uintptr_t address);
+    /// @note The result is cached in a fixed-size table, where addresses sharing a slot replace each other.
+    Instruction disassemble(uintptr_t address);
 
     /// @brief Get the disassembled instructions from a given address.
     /// @param start The start address.
@@ -32,4 +59,13 @@ namespace disasm {
     /// @return The disassembled instructions.
     std::vector<Instruction> disassemble(uintptr_t start, uintptr_t end);
 
+    /// @brief Check if the address directly follows a `call` instruction, i.e. it can be a return address.
+    /// @param address The address to check.
+    /// @return Whether a call instruction ends right before the address.
+    /// @note The result is cached until `clearCallCache` is called.
+    bool followsCall(uintptr_t address);
+
+    /// @brief Forget the results of `followsCall` (the probed addresses differ for every crash).
+    void clearCallCache();
+
 }
\ No newline at end of file
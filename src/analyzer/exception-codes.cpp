@@ -1,4 +1,5 @@
 #include "exception-codes.hpp"
+#include "symbol-service.hpp"
 
 #include <fmt/format.h>
 #include <sstream>
@@ -196,13 +197,14 @@ namespace analyzer::exceptions {
             if (!targetName || targetName[0] == '\0' || targetName[1] == '\0') {
                 demangledName = "<Unknown type>";
             } else {
-                char demangledBuf[256];
-                size_t written = UnDecorateSymbolName(targetName + 1, demangledBuf, 256, UNDNAME_NO_ARGUMENTS);
-                if (written == 0) {
-                    demangledName = "<Unknown type>";
-                } else {
-                    demangledName = std::string(demangledBuf, demangledBuf + written);
-                }
+                demangledName = SymbolService::get().call([&]() -> std::string {
+                    char demangledBuf[256];
+                    size_t written = UnDecorateSymbolName(targetName + 1, demangledBuf, 256, UNDNAME_NO_ARGUMENTS);
+                    if (written == 0) {
+                        return "<Unknown type>";
+                    }
+                    return std::string(demangledBuf, demangledBuf + written);
+                });
             }
 
             if (isStdException) {
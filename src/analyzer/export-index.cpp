@@ -0,0 +1,79 @@
+#include "export-index.hpp"
+#include "symbol-service.hpp"
+
+#include <DbgHelp.h>
+#include <string>
+
+#include "../utils/pe-image.hpp"
+#include "../utils/string-arena.hpp"
+
+namespace analyzer {
+
+    ExportIndex &ExportIndex::get() {
+        static ExportIndex index;
+        return index;
+    }
+
+    ExportIndex::ExportIndex() {
+        ModuleRegistry::get().addUnloadListener([this](const ModuleInfo &module) {
+            invalidate(module);
+        });
+    }
+
+    void ExportIndex::invalidate(const ModuleInfo &module) {
+        std::lock_guard lock(m_mutex);
+        m_tables.erase(module.handle);
+    }
+
+    std::shared_ptr<const utils::SymbolTable> ExportIndex::build(const ModuleInfo &module) {
+        auto table = std::make_shared<utils::SymbolTable>();
+
+        auto image = utils::pe::Image::fromMemory(reinterpret_cast<const uint8_t *>(module.baseAddress), module.size);
+        if (image) {
+            for (const auto &symbol: image->functionExports()) {
+                table->add(symbol.rva, symbol.name);
+            }
+        }
+
+        table->finalize();
+        return table;
+    }
+
+    /// @brief Convert a decorated MSVC name ("?method@Class@@...") into "Class::method".
+    static std::string_view undecorate(std::string_view name) {
+        if (name.empty() || name[0] != '?') {
+            return utils::internSymbol(name);
+        }
+
+        std::string decorated(name);
+        return SymbolService::get().call([&] {
+            char buffer[1024];
+            if (UnDecorateSymbolName(decorated.c_str(), buffer, sizeof(buffer), UNDNAME_NAME_ONLY) == 0) {
+                return utils::internSymbol(name);
+            }
+            return utils::internSymbol(buffer);
+        });
+    }
+
+    std::optional<ExportIndex::Symbol> ExportIndex::find(const ModuleInfo &module, uintptr_t address) {
+        if (address < module.baseAddress) return std::nullopt;
+
+        std::shared_ptr<const utils::SymbolTable> table;
+        {
+            std::lock_guard lock(m_mutex);
+            auto it = m_tables.find(module.handle);
+            if (it != m_tables.end() && it->second.path == module.path) {
+                table = it->second.table;
+            } else {
+                table = build(module);
+                m_tables[module.handle] = {module.path, table};
+            }
+        }
+
+        auto entry = table->find(address - module.baseAddress);
+        if (!entry) return std::nullopt;
+
+        return Symbol{entry->address, undecorate(table->getName(*entry))};
+    }
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+#include "module-registry.hpp"
+#include "../utils/symbol-table.hpp"
+
+namespace analyzer {
+
+    /// @brief Symbol source based on the export tables of loaded modules.
+    /// Mods usually ship without debug symbols, but their exported functions still have names.
+    class ExportIndex {
+    public:
+        struct Symbol {
+            uintptr_t address; // Address of the exported function, relative to the module
+            std::string_view name; // Undecorated name, interned in the analysis arena
+        };
+
+        /// @brief Get the process-wide index.
+        static ExportIndex &get();
+
+        /// @brief Find the closest export at or before the address.
+        /// The export table of the module is parsed the first time an address inside it is looked up.
+        /// @param module The module containing the address
+        /// @param address The absolute address
+        std::optional<Symbol> find(const ModuleInfo &module, uintptr_t address);
+
+        /// @brief Drop the parsed export table of the module.
+        void invalidate(const ModuleInfo &module);
+
+    private:
+        ExportIndex();
+
+        struct Entry {
+            std::string_view path; // Used to detect a different module loaded at the same address
+            std::shared_ptr<const utils::SymbolTable> table;
+        };
+
+        static std::shared_ptr<const utils::SymbolTable> build(const ModuleInfo &module);
+
+        std::mutex m_mutex;
+        std::unordered_map<HMODULE, Entry> m_tables;
+    };
+
+}
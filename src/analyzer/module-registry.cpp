@@ -0,0 +1,157 @@
+#include "module-registry.hpp"
+
+#include <psapi.h>
+#include <algorithm>
+#include <fmt/format.h>
+
+#include "../utils/string-arena.hpp"
+#include "../utils/utils.hpp"
+
+namespace analyzer {
+
+    ModuleRegistry &ModuleRegistry::get() {
+        static ModuleRegistry registry;
+        return registry;
+    }
+
+    std::vector<HMODULE> ModuleRegistry::enumerateModules() {
+        auto process = GetCurrentProcess();
+        std::vector<HMODULE> handles(256);
+
+        // Modules can be loaded between the calls, so retry until the buffer is large enough
+        while (true) {
+            DWORD needed = 0;
+            auto available = static_cast<DWORD>(handles.size() * sizeof(HMODULE));
+            if (!EnumProcessModules(process, handles.data(), available, &needed)) {
+                return {};
+            }
+
+            if (needed <= available) {
+                handles.resize(needed / sizeof(HMODULE));
+                return handles;
+            }
+
+            handles.resize(needed / sizeof(HMODULE) + 16);
+        }
+    }
+
+    ModuleInfo ModuleRegistry::queryModule(HMODULE handle) {
+        ModuleInfo info{handle, {}, {}, reinterpret_cast<uintptr_t>(handle), 0};
+
+        char buffer[MAX_PATH];
+        auto length = GetModuleFileNameA(handle, buffer, MAX_PATH);
+        if (length == 0 || buffer[0] == 0) {
+            info.name = utils::intern(fmt::format("<Unknown: 0x{:X}>", reinterpret_cast<uintptr_t>(handle)));
+        } else {
+            info.path = utils::intern({buffer, length});
+            info.name = utils::intern(utils::getFileName(buffer));
+        }
+
+        MODULEINFO moduleInfo;
+        if (GetModuleInformation(GetCurrentProcess(), handle, &moduleInfo, sizeof(moduleInfo))) {
+            info.baseAddress = reinterpret_cast<uintptr_t>(moduleInfo.lpBaseOfDll);
+            info.size = moduleInfo.SizeOfImage;
+        }
+
+        return info;
+    }
+
+    void ModuleRegistry::refresh() {
+        std::vector<ModuleInfo> unloaded;
+        {
+            std::lock_guard lock(m_mutex);
+            unloaded = refreshLocked();
+        }
+        notifyUnloaded(unloaded);
+    }
+
+    std::vector<ModuleInfo> ModuleRegistry::refreshLocked() {
+        std::vector<ModuleInfo> unloaded;
+
+        auto handles = enumerateModules();
+        if (handles.empty()) return unloaded;
+
+        // Drop the modules that were unloaded
+        std::sort(handles.begin(), handles.end());
+        m_modules.retain([&](const auto &interval) {
+            if (std::binary_search(handles.begin(), handles.end(), interval.value.handle)) {
+                return true;
+            }
+            unloaded.push_back(interval.value);
+            return false;
+        });
+
+        m_modules.reserve(handles.size());
+        for (auto handle: handles) {
+            auto base = reinterpret_cast<uintptr_t>(handle);
+            if (m_modules.findExact(base)) continue;
+
+            auto info = queryModule(handle);
+            m_modules.insert(info.baseAddress, info.baseAddress + info.size, info);
+        }
+
+        return unloaded;
+    }
+
+    void ModuleRegistry::notifyUnloaded(const std::vector<ModuleInfo> &modules) {
+        if (modules.empty()) return;
+
+        std::vector<UnloadListener> listeners;
+        {
+            std::lock_guard lock(m_mutex);
+            listeners = m_unloadListeners;
+        }
+
+        for (const auto &module: modules) {
+            for (const auto &listener: listeners) {
+                listener(module);
+            }
+        }
+    }
+
+    void ModuleRegistry::addUnloadListener(UnloadListener listener) {
+        std::lock_guard lock(m_mutex);
+        m_unloadListeners.push_back(std::move(listener));
+    }
+
+    std::optional<ModuleInfo> ModuleRegistry::find(uintptr_t address) {
+        std::vector<ModuleInfo> unloaded;
+        std::optional<ModuleInfo> result;
+        {
+            std::lock_guard lock(m_mutex);
+
+            if (auto interval = m_modules.find(address)) {
+                return interval->value;
+            }
+
+            // The module might have been loaded after the last refresh
+            HMODULE handle = nullptr;
+            if (!GetModuleHandleEx(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                                   (LPCTSTR) address, &handle) || handle == nullptr) {
+                return std::nullopt;
+            }
+
+            unloaded = refreshLocked();
+            if (auto interval = m_modules.find(address)) {
+                result = interval->value;
+            }
+        }
+
+        notifyUnloaded(unloaded);
+        return result;
+    }
+
+    std::optional<ModuleInfo> ModuleRegistry::find(HMODULE handle) {
+        std::lock_guard lock(m_mutex);
+        if (auto interval = m_modules.findExact(reinterpret_cast<uintptr_t>(handle))) {
+            return interval->value;
+        }
+        return std::nullopt;
+    }
+
+    size_t ModuleRegistry::size() const {
+        std::lock_guard lock(m_mutex);
+        return m_modules.size();
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Windows.h>
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "../utils/interval-map.hpp"
+
+namespace analyzer {
+
+    /// @note All strings are interned (see utils::intern), so the struct is cheap to copy.
+    struct ModuleInfo {
+        HMODULE handle;
+        std::string_view name;
+        std::string_view path;
+        uintptr_t baseAddress;
+        uintptr_t size;
+
+        [[nodiscard]] bool contains(void *address) const {
+            return address >= (void *) baseAddress && address < (void *) (baseAddress + size);
+        }
+    };
+
+    /// @brief Index of the modules loaded into the process, sorted by address range.
+    /// Name and path of every module are queried only once, when the module is first seen.
+    class ModuleRegistry {
+    public:
+        /// @brief Get the process-wide registry.
+        static ModuleRegistry &get();
+
+        /// @brief Update the registry with the currently loaded modules.
+        /// Only modules which were not seen before are queried, unloaded modules are removed.
+        void refresh();
+
+        /// @brief Find the module containing the address.
+        /// @note If the address is not inside a known module, but belongs to one (e.g. it was loaded
+        /// after the last refresh), the registry is refreshed.
+        std::optional<ModuleInfo> find(uintptr_t address);
+
+        /// @brief Find the module by its handle.
+        std::optional<ModuleInfo> find(HMODULE handle);
+
+        /// @brief Amount of known modules.
+        size_t size() const;
+
+        using UnloadListener = std::function<void(const ModuleInfo &)>;
+
+        /// @brief Register a callback which is called for every module found to be unloaded during a refresh.
+        /// Used to invalidate per-module caches.
+        void addUnloadListener(UnloadListener listener);
+
+    private:
+        ModuleRegistry() = default;
+
+        /// @brief Get the handles of all loaded modules.
+        static std::vector<HMODULE> enumerateModules();
+
+        /// @brief Query the information about a module that wasn't seen before.
+        static ModuleInfo queryModule(HMODULE handle);
+
+        /// @return The modules that were unloaded since the last refresh.
+        std::vector<ModuleInfo> refreshLocked();
+
+        /// @brief Call the unload listeners (without holding the lock).
+        void notifyUnloaded(const std::vector<ModuleInfo> &modules);
+
+        mutable std::mutex m_mutex;
+        utils::IntervalMap<ModuleInfo> m_modules;
+        std::vector<UnloadListener> m_unloadListeners;
+    };
+
+}
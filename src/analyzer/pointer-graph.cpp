@@ -0,0 +1,124 @@
+#include "pointer-graph.hpp"
+
+#include <algorithm>
+#include <vector>
+#include <fmt/format.h>
+
+#include "analyzer.hpp"
+#include "../utils/memory.hpp"
+
+namespace analyzer {
+
+    /// @brief Read the pointer stored at the address.
+    /// @return Whether the address could be read.
+    static bool readPointer(uintptr_t address, uintptr_t &value) {
+        if (utils::mem::getReadableSize(address, sizeof(uintptr_t)) < sizeof(uintptr_t)) {
+            return false;
+        }
+        // The snapshot might be stale by now, and this runs on the worker pool
+        return utils::mem::readMemory(address, &value, sizeof(value));
+    }
+
+    /// @brief Describe a value that is not a pointer to another pointer.
+    static std::string describeValue(uintptr_t value, ValueType type) {
+        switch (type) {
+            case ValueType::CCObject:
+                return fmt::format("-> 0x{:X} ({})", value, Analyzer::getTypeName(value));
+            case ValueType::Function:
+                return fmt::format("-> 0x{:X} -> {}", value, Analyzer::getFunction(value).toString());
+            case ValueType::String:
+                return fmt::format("-> 0x{:X} -> {}", value, Analyzer::getString(value));
+            case ValueType::WideString:
+                return fmt::format("-> 0x{:X} -> {}", value, Analyzer::getWideString(value));
+            default:
+                return fmt::format("-> 0x{:X}", value);
+        }
+    }
+
+    bool PointerGraph::lookup(uintptr_t address, std::string &chain, size_t &walked) const {
+        std::lock_guard lock(m_mutex);
+        walked = m_chains.size();
+        auto it = m_chains.find(address);
+        if (it == m_chains.end()) return false;
+        chain = it->second;
+        return true;
+    }
+
+    std::string PointerGraph::describe(uintptr_t address) {
+        std::string chain;
+        size_t walked;
+        if (lookup(address, chain, walked)) {
+            return chain;
+        }
+
+        struct Step {
+            uintptr_t address;
+            uintptr_t value;
+            ValueType type;
+        };
+
+        // Follow the chain until it reaches a known address, a cycle or a value that is not a pointer
+        std::vector<Step> path;
+        std::string next; // Chain of the address the last step points to
+        uintptr_t current = address;
+        while (true) {
+            if (lookup(current, next, walked)) break;
+
+            auto visited = std::find_if(path.begin(), path.end(), [&](const Step &step) {
+                return step.address == current;
+            });
+            if (visited != path.end()) {
+                next = "[cycle]";
+                break;
+            }
+
+            uintptr_t value;
+            if (!readPointer(current, value)) break;
+
+            if (path.size() >= MAX_DEPTH || walked + path.size() >= NODE_BUDGET) {
+                if (path.empty()) {
+                    return fmt::format("-> 0x{:X} [...]", value);
+                }
+                next = "[...]";
+                break;
+            }
+
+            auto type = Analyzer::getValueType(value);
+            path.push_back({current, value, type});
+            if (type != ValueType::Pointer) break;
+            current = value;
+        }
+
+        // Build the chains from the end, so every step can be reused by other slots
+        std::vector<std::string> chains(path.size());
+        for (size_t i = path.size(); i-- > 0;) {
+            const auto &step = path[i];
+            if (step.type == ValueType::Pointer) {
+                chain = next.empty()
+                        ? fmt::format("-> 0x{:X}", step.value)
+                        : fmt::format("-> 0x{:X} {}", step.value, next);
+            } else {
+                chain = describeValue(step.value, step.type);
+            }
+            chains[i] = chain;
+            next = std::move(chain);
+        }
+
+        std::lock_guard lock(m_mutex);
+        for (size_t i = 0; i < path.size(); i++) {
+            m_chains.try_emplace(path[i].address, chains[i]);
+        }
+        return next;
+    }
+
+    void PointerGraph::clear() {
+        std::lock_guard lock(m_mutex);
+        m_chains.clear();
+    }
+
+    size_t PointerGraph::size() const {
+        std::lock_guard lock(m_mutex);
+        return m_chains.size();
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace analyzer {
+
+    /// @brief Memoized walker for chains of pointers ("-> 0x... -> 0x... -> &\"string\"").
+    /// Every address is dereferenced and classified only once per crash, so registers and stack slots
+    /// pointing into the same structure share the work. Cycles (e.g. parent/child pointers) are detected.
+    /// @note Thread-safe. Two threads walking the same chain at once might both classify it.
+    class PointerGraph {
+    public:
+        /// @brief Maximum amount of pointers followed from a single address.
+        static constexpr size_t MAX_DEPTH = 10;
+
+        /// @brief Maximum amount of addresses walked per crash.
+        static constexpr size_t NODE_BUDGET = 8192;
+
+        /// @brief Describe the chain of pointers starting at the address.
+        /// @param address A readable address holding a pointer
+        /// @return The chain, e.g. "-> 0x1234 -> 0x5678 (cocos2d::CCNode*)".
+        std::string describe(uintptr_t address);
+
+        /// @brief Forget all walked addresses.
+        void clear();
+
+        /// @brief Amount of walked addresses.
+        [[nodiscard]] size_t size() const;
+
+    private:
+        /// @brief Get the chain of an address that was already walked.
+        /// @return Whether the address was walked.
+        bool lookup(uintptr_t address, std::string &chain, size_t &walked) const;
+
+        mutable std::mutex m_mutex;
+        std::unordered_map<uintptr_t, std::string> m_chains;
+    };
+
+}
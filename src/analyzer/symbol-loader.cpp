@@ -0,0 +1,163 @@
+#include "symbol-loader.hpp"
+
+#include <DbgHelp.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include <fmt/format.h>
+
+#include "symbol-service.hpp"
+
+namespace analyzer {
+
+    /// @brief Amount of slowest modules listed in the diagnostics.
+    static constexpr size_t SLOWEST_MODULES = 5;
+
+    SymbolLoader &SymbolLoader::get() {
+        static SymbolLoader loader;
+        return loader;
+    }
+
+    SymbolLoader::SymbolLoader() {
+        ModuleRegistry::get().addUnloadListener([this](const ModuleInfo &module) {
+            unload(module);
+        });
+    }
+
+    bool SymbolLoader::initialize() {
+        return SymbolService::get().call([this] { return initializeOnService(); });
+    }
+
+    bool SymbolLoader::initializeOnService() {
+        if (m_initializeAttempted) return m_initialized;
+        m_initializeAttempted = true;
+
+        // Registering a module is cheap, its symbols are only loaded by the first lookup inside it.
+        // StackWalk64 registers every module on the stack, so this keeps the walk from loading all their PDBs.
+        SymSetOptions(SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES | SYMOPT_UNDNAME |
+                      SYMOPT_FAIL_CRITICAL_ERRORS | SYMOPT_NO_PROMPTS);
+        m_initialized = SymInitialize(GetCurrentProcess(), nullptr, false);
+        return m_initialized;
+    }
+
+    bool SymbolLoader::load(const ModuleInfo &module) {
+        return SymbolService::get().call([&] { return loadOnService(module); });
+    }
+
+    bool SymbolLoader::loadOnService(const ModuleInfo &module) {
+        if (!m_initialized) return false;
+
+        if (auto it = m_modules.find(module.handle); it != m_modules.end()) {
+            return it->second.loaded;
+        }
+
+        auto process = GetCurrentProcess();
+        std::string path(module.path);
+        auto start = std::chrono::steady_clock::now();
+        auto base = SymLoadModuleEx(
+                process, nullptr, path.c_str(), nullptr,
+                static_cast<DWORD64>(module.baseAddress), static_cast<DWORD>(module.size), nullptr, 0
+        );
+        // Returns 0 with no error if somebody else registered the module already
+        bool loaded = base != 0 || GetLastError() == ERROR_SUCCESS;
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        ModuleLoad result;
+        result.name = module.name;
+        result.loaded = loaded;
+        result.registerMilliseconds = elapsed.count();
+        m_modules[module.handle] = result;
+        return loaded;
+    }
+
+    bool SymbolLoader::load(uintptr_t address) {
+        auto module = ModuleRegistry::get().find(address);
+        return module && load(*module);
+    }
+
+    bool SymbolLoader::query(const ModuleInfo &module, const std::function<void()> &lookup) {
+        return SymbolService::get().call([&] { return queryOnService(module, lookup); });
+    }
+
+    bool SymbolLoader::query(uintptr_t address, const std::function<void()> &lookup) {
+        auto module = ModuleRegistry::get().find(address);
+        return module && query(*module, lookup);
+    }
+
+    bool SymbolLoader::queryOnService(const ModuleInfo &module, const std::function<void()> &lookup) {
+        if (!loadOnService(module)) return false;
+
+        auto &load = m_modules[module.handle];
+        if (load.symbolsLoaded) {
+            lookup();
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        lookup();
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+
+        load.symbolsLoaded = true;
+        load.symbolsMilliseconds = elapsed.count();
+
+        IMAGEHLP_MODULE64 moduleInfo{};
+        moduleInfo.SizeOfStruct = sizeof(IMAGEHLP_MODULE64);
+        if (SymGetModuleInfo64(GetCurrentProcess(), static_cast<DWORD64>(module.baseAddress), &moduleInfo)) {
+            load.debugInfo = moduleInfo.SymType != SymNone && moduleInfo.SymType != SymExport &&
+                             moduleInfo.SymType != SymDeferred;
+        }
+        return true;
+    }
+
+    void SymbolLoader::unload(const ModuleInfo &module) {
+        SymbolService::get().call([&] { unloadOnService(module); });
+    }
+
+    void SymbolLoader::unloadOnService(const ModuleInfo &module) {
+        auto it = m_modules.find(module.handle);
+        if (it == m_modules.end()) return;
+
+        if (it->second.loaded) {
+            SymUnloadModule64(GetCurrentProcess(), static_cast<DWORD64>(module.baseAddress));
+        }
+        m_modules.erase(it);
+    }
+
+    std::string SymbolLoader::getStatsMessage() {
+        auto modules = SymbolService::get().call([this] {
+            std::vector<ModuleLoad> loads;
+            loads.reserve(m_modules.size());
+            for (const auto &[handle, load]: m_modules) {
+                loads.push_back(load);
+            }
+            return loads;
+        });
+
+        double registerTotal = 0, symbolsTotal = 0;
+        size_t symbolsLoaded = 0, debugInfo = 0;
+        for (const auto &load: modules) {
+            registerTotal += load.registerMilliseconds;
+            symbolsTotal += load.symbolsMilliseconds;
+            if (load.symbolsLoaded) symbolsLoaded++;
+            if (load.debugInfo) debugInfo++;
+        }
+
+        std::string message = fmt::format(
+                "- DbgHelp modules: {} registered ({:.3f} ms), {} with symbols loaded ({:.3f} ms), {} with debug info",
+                modules.size(), registerTotal, symbolsLoaded, symbolsTotal, debugInfo
+        );
+
+        auto count = std::min(symbolsLoaded, SLOWEST_MODULES);
+        std::partial_sort(modules.begin(), modules.begin() + count, modules.end(), [](auto &a, auto &b) {
+            return a.symbolsMilliseconds > b.symbolsMilliseconds;
+        });
+        for (size_t i = 0; i < count; i++) {
+            const auto &load = modules[i];
+            message += fmt::format(
+                    "\n  - {}: {:.3f} ms{}", load.name, load.symbolsMilliseconds, load.debugInfo ? "" : " (no debug info)"
+            );
+        }
+        return message;
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Windows.h>
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "module-registry.hpp"
+
+namespace analyzer {
+
+    /// @brief Registers modules with DbgHelp one at a time, when an address first lands in them.
+    /// Symbols stay deferred until the first lookup in the module, which is timed per module.
+    /// DbgHelp is initialized once per process, so loaded modules are kept across crashes and reloads.
+    /// @note The state is only touched by the symbol service thread (see SymbolService).
+    class SymbolLoader {
+    public:
+        /// @brief Result of loading the symbols of a module.
+        struct ModuleLoad {
+            std::string_view name;
+            bool loaded = false; // DbgHelp accepted the module
+            bool symbolsLoaded = false; // A lookup made DbgHelp load the deferred symbols
+            bool debugInfo = false; // A PDB (or other debug information) was found
+            double registerMilliseconds = 0; // SymLoadModuleEx (cheap, since symbols are deferred)
+            double symbolsMilliseconds = 0; // First lookup in the module, which loads the symbols
+        };
+
+        /// @brief Get the process-wide loader.
+        static SymbolLoader &get();
+
+        /// @brief Initialize DbgHelp without registering any modules. Only the first call does anything.
+        /// @return Whether DbgHelp is usable.
+        bool initialize();
+
+        /// @brief Whether DbgHelp was initialized successfully.
+        [[nodiscard]] bool isInitialized() const { return m_initialized; }
+
+        /// @brief Register the module with DbgHelp, if it wasn't registered yet.
+        /// @return Whether DbgHelp knows the module.
+        bool load(const ModuleInfo &module);
+
+        /// @brief Register the module containing the address.
+        /// @return Whether DbgHelp knows the module (false if the address is not inside any module).
+        bool load(uintptr_t address);
+
+        /// @brief Run a symbol or line lookup in the module on the service thread, registering the module first.
+        /// Symbols are deferred until the first lookup, so the duration of that one is recorded as the load time.
+        /// @return Whether the module is known to DbgHelp (the lookup doesn't run otherwise).
+        bool query(const ModuleInfo &module, const std::function<void()> &lookup);
+
+        /// @brief Run a lookup in the module containing the address.
+        bool query(uintptr_t address, const std::function<void()> &lookup);
+
+        /// @brief Get the load times of the registered modules as a report section.
+        [[nodiscard]] std::string getStatsMessage();
+
+    private:
+        SymbolLoader();
+
+        /// @brief Remove the module from DbgHelp.
+        void unload(const ModuleInfo &module);
+
+        /// @brief Implementations of the methods above, run on the service thread.
+        bool initializeOnService();
+        bool loadOnService(const ModuleInfo &module);
+        void unloadOnService(const ModuleInfo &module);
+        bool queryOnService(const ModuleInfo &module, const std::function<void()> &lookup);
+
+        bool m_initializeAttempted = false;
+        bool m_initialized = false;
+        std::unordered_map<HMODULE, ModuleLoad> m_modules;
+    };
+
+}
@@ -0,0 +1,353 @@
+#include "symbol-resolver.hpp"
+
+#include <DbgHelp.h>
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+
+#include "ehdata-structs.hpp"
+#include "export-index.hpp"
+#include "symbol-loader.hpp"
+#include "symbol-service.hpp"
+#include "../utils/config.hpp"
+#include "../utils/geode-util.hpp"
+#include "../utils/memory.hpp"
+#include "../utils/string-arena.hpp"
+
+// Import a TulipHook function
+PVOID GeodeFunctionTableAccess64(HANDLE hProcess, DWORD64 AddrBase);
+
+namespace analyzer {
+
+    uintptr_t SymbolQuery::functionStart() {
+        if (!m_functionStart) {
+            m_functionStart = module ? utils::mem::findFunctionStart(address, module->baseAddress) : 0;
+        }
+        return *m_functionStart;
+    }
+
+    /// @brief TulipHook hook handlers, which are allocated outside of any module.
+    class HookHandlerProvider : public SymbolProvider {
+    public:
+        [[nodiscard]] std::string_view getName() const override { return "hookhandler"; }
+
+        [[nodiscard]] bool appliesTo(const ModuleInfo *module) const override {
+            return module == nullptr;
+        }
+
+        std::optional<MethodInfo> resolve(SymbolQuery &query) override {
+            if (!GeodeFunctionTableAccess64(GetCurrentProcess(), static_cast<DWORD64>(query.address))) {
+                return std::nullopt;
+            }
+
+            MethodInfo info;
+            info.special = MethodInfo::Special::HookHandler;
+            info.address = query.address;
+            return info;
+        }
+    };
+
+    /// @brief Function names from the bindings (CodegenData.txt), for the game and libcocos2d.
+    class BindingsProvider : public SymbolProvider {
+    public:
+        [[nodiscard]] std::string_view getName() const override { return "bindings"; }
+
+        [[nodiscard]] bool appliesTo(const ModuleInfo *module) const override {
+            return module && (isMainModule(*module) || isCocosModule(*module));
+        }
+
+        std::optional<MethodInfo> resolve(SymbolQuery &query) override {
+            auto methodStart = query.functionStart();
+            if (methodStart == 0) return std::nullopt;
+
+            auto &module = *query.module;
+            auto methodInfo = utils::geode::getFunctionAddress(
+                    query.address, module.baseAddress, isCocosModule(module), methodStart
+            );
+            if (methodInfo.first == 0 || methodInfo.second.empty()) {
+                return std::nullopt;
+            }
+
+            auto moduleOffset = query.moduleOffset();
+            return MethodInfo{module.name, moduleOffset, methodInfo.second, moduleOffset - methodInfo.first};
+        }
+
+    private:
+        static bool isMainModule(const ModuleInfo &module) {
+            return module.handle == GetModuleHandle(nullptr);
+        }
+
+        static bool isCocosModule(const ModuleInfo &module) {
+            return module.name == "libcocos2d.dll";
+        }
+    };
+
+    /// @brief Debug symbols loaded by DbgHelp.
+    class DbgHelpProvider : public SymbolProvider {
+    public:
+        [[nodiscard]] std::string_view getName() const override { return "dbghelp"; }
+
+        [[nodiscard]] bool appliesTo(const ModuleInfo *module) const override {
+            return module != nullptr;
+        }
+
+        std::optional<MethodInfo> resolve(SymbolQuery &query) override {
+            return SymbolService::get().call([&] { return resolveOnService(query); });
+        }
+
+    private:
+        static std::optional<MethodInfo> resolveOnService(SymbolQuery &query) {
+            auto proc = GetCurrentProcess();
+            auto address = static_cast<DWORD64>(query.address);
+            static char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
+            auto pSymbol = (PSYMBOL_INFO) buffer;
+            pSymbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+            pSymbol->MaxNameLen = MAX_SYM_NAME;
+            DWORD64 displacement;
+            bool found = false;
+            auto registered = SymbolLoader::get().query(*query.module, [&] {
+                found = SymFromAddr(proc, address, &displacement, pSymbol);
+            });
+            if (!registered || !found) {
+                return std::nullopt;
+            }
+
+            if (auto entry = SymFunctionTableAccess64(proc, address)) {
+                auto moduleBase = SymGetModuleBase64(proc, address);
+                auto runtimeFunction = static_cast<PRUNTIME_FUNCTION>(entry);
+                auto unwindInfo = reinterpret_cast<PUNWIND_INFO>(moduleBase + runtimeFunction->UnwindInfoAddress);
+
+                // This is a chain of unwind info structures, so we traverse back to the first one
+                while (unwindInfo->Flags & UNW_FLAG_CHAININFO) {
+                    runtimeFunction = (PRUNTIME_FUNCTION) &(unwindInfo->UnwindCode[(unwindInfo->CountOfCodes + 1) & ~1]);
+                    unwindInfo = reinterpret_cast<PUNWIND_INFO>(moduleBase + runtimeFunction->UnwindInfoAddress);
+                }
+
+                if (moduleBase + runtimeFunction->BeginAddress != pSymbol->Address) {
+                    // the symbol address is not the same as the function address
+                    return std::nullopt;
+                }
+            }
+
+            return MethodInfo{
+                    query.module->name, query.moduleOffset(), pSymbol->Name, static_cast<uintptr_t>(displacement)
+            };
+        }
+    };
+
+    /// @brief Names of exported functions (mods usually ship without debug symbols).
+    class ExportsProvider : public SymbolProvider {
+    public:
+        [[nodiscard]] std::string_view getName() const override { return "exports"; }
+
+        [[nodiscard]] bool appliesTo(const ModuleInfo *module) const override {
+            return module != nullptr;
+        }
+
+        std::optional<MethodInfo> resolve(SymbolQuery &query) override {
+            auto methodStart = query.functionStart();
+            if (methodStart == 0) return std::nullopt;
+
+            // Only use the export if it's not before the function start (the function itself might not be exported)
+            auto &module = *query.module;
+            auto symbol = ExportIndex::get().find(module, query.address);
+            if (!symbol || symbol->address < methodStart - module.baseAddress) {
+                return std::nullopt;
+            }
+
+            auto moduleOffset = query.moduleOffset();
+            return MethodInfo{module.name, moduleOffset, symbol->name, moduleOffset - symbol->address};
+        }
+    };
+
+    /// @brief Function start found from the unwind info or by scanning for the "int 3" padding.
+    class HeuristicProvider : public SymbolProvider {
+    public:
+        [[nodiscard]] std::string_view getName() const override { return "heuristic"; }
+
+        [[nodiscard]] bool appliesTo(const ModuleInfo *module) const override {
+            return module != nullptr;
+        }
+
+        std::optional<MethodInfo> resolve(SymbolQuery &query) override {
+            auto methodStart = query.functionStart();
+            if (methodStart == 0) return std::nullopt;
+
+            auto methodOffset = query.address - methodStart;
+            methodStart -= query.module->baseAddress; // Get the offset from the module base
+            return MethodInfo{
+                    query.module->name, query.moduleOffset(), fmt::format("<0x{:x}>", methodStart), methodOffset
+            };
+        }
+    };
+
+    SymbolResolver &SymbolResolver::get() {
+        static SymbolResolver resolver;
+        return resolver;
+    }
+
+    SymbolResolver::SymbolResolver() : m_cache(
+            config::get().symbol_cache_size > 0 ? config::get().symbol_cache_size : DEFAULT_CACHE_SIZE
+    ) {
+        m_providers.push_back(std::make_unique<HookHandlerProvider>());
+        m_providers.push_back(std::make_unique<BindingsProvider>());
+        m_providers.push_back(std::make_unique<DbgHelpProvider>());
+        m_providers.push_back(std::make_unique<ExportsProvider>());
+        m_providers.push_back(std::make_unique<HeuristicProvider>());
+
+        setOrder(config::get().symbol_providers);
+
+        ModuleRegistry::get().addUnloadListener([this](const ModuleInfo &module) {
+            invalidate(module);
+        });
+    }
+
+    void SymbolResolver::setOrder(std::string_view order) {
+        m_order.clear();
+        if (order.empty()) order = DEFAULT_ORDER;
+
+        while (!order.empty()) {
+            auto delimiter = order.find(',');
+            auto name = order.substr(0, delimiter);
+            order = delimiter == std::string_view::npos ? std::string_view() : order.substr(delimiter + 1);
+
+            // Trim whitespace
+            while (!name.empty() && name.front() == ' ') name.remove_prefix(1);
+            while (!name.empty() && name.back() == ' ') name.remove_suffix(1);
+
+            for (auto &provider: m_providers) {
+                if (provider->getName() == name &&
+                    std::find(m_order.begin(), m_order.end(), provider.get()) == m_order.end()) {
+                    m_order.push_back(provider.get());
+                }
+            }
+        }
+
+        // Don't leave the resolver without any providers because of a typo
+        if (m_order.empty()) {
+            setOrder(DEFAULT_ORDER);
+        }
+    }
+
+    MethodInfo SymbolResolver::resolve(uintptr_t address, bool withLine) {
+        std::optional<CachedSymbol> cached;
+        {
+            std::lock_guard lock(m_cacheMutex);
+
+            // Reloaded bindings can change the names
+            auto version = utils::geode::getSymbolTablesVersion();
+            if (version != m_cacheVersion) {
+                m_cache.clear();
+                m_cacheVersion = version;
+            }
+
+            if (auto entry = m_cache.get(address)) {
+                cached = *entry;
+            }
+        }
+
+        if (cached) {
+            m_cacheHits.fetch_add(1, std::memory_order_relaxed);
+            if (cached->lineResolved || !withLine) {
+                return cached->info;
+            }
+        } else {
+            m_cacheMisses.fetch_add(1, std::memory_order_relaxed);
+            cached = CachedSymbol{resolveUncached(address)};
+        }
+
+        if (withLine && !cached->lineResolved) {
+            resolveLine(address, cached->info);
+            cached->lineResolved = true;
+        }
+
+        {
+            std::lock_guard lock(m_cacheMutex);
+            m_cache.put(address, *cached);
+        }
+        return cached->info;
+    }
+
+    void SymbolResolver::resolveLine(uintptr_t address, MethodInfo &info) {
+        DWORD displacement;
+        IMAGEHLP_LINE64 lineInfo;
+        lineInfo.SizeOfStruct = sizeof(IMAGEHLP_LINE64);
+        SymbolLoader::get().query(address, [&] {
+            if (SymGetLineFromAddr64(GetCurrentProcess(), static_cast<DWORD64>(address), &displacement, &lineInfo)) {
+                info.file = utils::intern(lineInfo.FileName);
+                info.line = lineInfo.LineNumber;
+            }
+        });
+    }
+
+    void SymbolResolver::invalidate(const ModuleInfo &module) {
+        std::lock_guard lock(m_cacheMutex);
+        m_cache.eraseIf([&](uintptr_t address, const CachedSymbol &) {
+            return address >= module.baseAddress && address - module.baseAddress < module.size;
+        });
+    }
+
+    void SymbolResolver::clear() {
+        std::lock_guard lock(m_cacheMutex);
+        m_cache.clear();
+    }
+
+    MethodInfo SymbolResolver::resolveUncached(uintptr_t address) {
+        SymbolQuery query(address, ModuleRegistry::get().find(address));
+        const ModuleInfo *module = query.module ? &*query.module : nullptr;
+
+        for (auto provider: m_order) {
+            auto &stats = provider->getStats();
+            if (!provider->appliesTo(module)) {
+                stats.skipped.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            auto result = provider->resolve(query);
+            auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+            stats.nanoseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+
+            if (result) {
+                stats.hits.fetch_add(1, std::memory_order_relaxed);
+                return *result;
+            }
+            stats.misses.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Nobody knows this address
+        if (module) {
+            return {module->name, query.moduleOffset(), 0};
+        }
+        return {0, address};
+    }
+
+    std::string SymbolResolver::getStatsMessage() {
+        auto hits = m_cacheHits.load();
+        auto misses = m_cacheMisses.load();
+        size_t cacheSize, cacheCapacity;
+        {
+            std::lock_guard lock(m_cacheMutex);
+            cacheSize = m_cache.size();
+            cacheCapacity = m_cache.capacity();
+        }
+
+        std::string message = fmt::format(
+                "- Symbol cache: {} hits, {} misses ({:.1f}% hit rate), {}/{} entries\n",
+                hits, misses, hits + misses == 0 ? 0.0 : 100.0 * static_cast<double>(hits) / static_cast<double>(hits + misses),
+                cacheSize, cacheCapacity
+        );
+
+        message += "- Symbol providers:";
+        for (auto provider: m_order) {
+            auto &stats = provider->getStats();
+            message += fmt::format(
+                    "\n  - {}: {} hits, {} misses, {} skipped, {:.3f} ms",
+                    provider->getName(), stats.hits.load(), stats.misses.load(), stats.skipped.load(),
+                    static_cast<double>(stats.nanoseconds.load()) / 1'000'000.0
+            );
+        }
+        return message;
+    }
+
+}
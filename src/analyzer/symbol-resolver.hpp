@@ -0,0 +1,128 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "analyzer.hpp"
+#include "../utils/lru-cache.hpp"
+
+namespace analyzer {
+
+    /// @brief Address that is being resolved, shared between the symbol providers.
+    class SymbolQuery {
+    public:
+        SymbolQuery(uintptr_t address, std::optional<ModuleInfo> module)
+                : address(address), module(module) {}
+
+        const uintptr_t address; // Absolute address
+        const std::optional<ModuleInfo> module; // Module containing the address (if any)
+
+        /// @brief Offset of the address from the module base.
+        [[nodiscard]] uintptr_t moduleOffset() const {
+            return module ? address - module->baseAddress : address;
+        }
+
+        /// @brief Start of the function containing the address (absolute), or 0 if unknown.
+        /// @note Computed only once, the first time a provider needs it.
+        uintptr_t functionStart();
+
+    private:
+        std::optional<uintptr_t> m_functionStart;
+    };
+
+    /// @brief Counters of a symbol provider, shown in the diagnostics section.
+    struct ProviderStats {
+        std::atomic<uint64_t> hits = 0;
+        std::atomic<uint64_t> misses = 0;
+        std::atomic<uint64_t> skipped = 0; // The provider did not apply to the module
+        std::atomic<uint64_t> nanoseconds = 0;
+    };
+
+    /// @brief A source of function names.
+    class SymbolProvider {
+    public:
+        virtual ~SymbolProvider() = default;
+
+        /// @brief Name of the provider, used in the config and in the diagnostics.
+        [[nodiscard]] virtual std::string_view getName() const = 0;
+
+        /// @brief Whether the provider can resolve addresses inside the module.
+        /// @param module The module, or nullptr if the address is not inside any module
+        [[nodiscard]] virtual bool appliesTo(const ModuleInfo *module) const = 0;
+
+        /// @brief Try to resolve the address.
+        /// @return The function information, or std::nullopt to let the next provider try.
+        virtual std::optional<MethodInfo> resolve(SymbolQuery &query) = 0;
+
+        [[nodiscard]] ProviderStats &getStats() { return m_stats; }
+        [[nodiscard]] const ProviderStats &getStats() const { return m_stats; }
+
+    private:
+        ProviderStats m_stats;
+    };
+
+    /// @brief Resolves addresses by asking the symbol providers in the configured order.
+    class SymbolResolver {
+    public:
+        /// @brief Order used when the config doesn't specify one.
+        static constexpr std::string_view DEFAULT_ORDER = "hookhandler,bindings,dbghelp,exports,heuristic";
+
+        /// @brief Amount of cached addresses used when the config doesn't specify it.
+        static constexpr size_t DEFAULT_CACHE_SIZE = 4096;
+
+        /// @brief Get the process-wide resolver.
+        static SymbolResolver &get();
+
+        /// @brief Set the order of the providers.
+        /// @param order Comma-separated provider names. Providers that are not listed are disabled.
+        void setOrder(std::string_view order);
+
+        /// @brief Resolve an address using the first provider that knows it.
+        /// Results are cached by address, until the module is unloaded or the bindings are reloaded.
+        /// @param address The absolute address
+        /// @param withLine Whether to also look up the source file and line (using DbgHelp)
+        MethodInfo resolve(uintptr_t address, bool withLine = false);
+
+        /// @brief Drop the cached results for addresses inside the module.
+        void invalidate(const ModuleInfo &module);
+
+        /// @brief Drop all cached results (the names are freed with the analysis arena).
+        void clear();
+
+        /// @brief Get the enabled providers, in the order they are asked.
+        [[nodiscard]] const std::vector<SymbolProvider *> &getProviders() const { return m_order; }
+
+        /// @brief Get the statistics of all providers as a report section.
+        [[nodiscard]] std::string getStatsMessage();
+
+    private:
+        SymbolResolver();
+
+        /// @brief Ask the providers, without looking at the cache.
+        MethodInfo resolveUncached(uintptr_t address);
+
+        /// @brief Fill in the source file and line of the function.
+        static void resolveLine(uintptr_t address, MethodInfo &info);
+
+        struct CachedSymbol {
+            MethodInfo info;
+            bool lineResolved = false; // Line info was looked up (it might still be missing)
+        };
+
+        std::vector<std::unique_ptr<SymbolProvider>> m_providers;
+        std::vector<SymbolProvider *> m_order;
+
+        std::mutex m_cacheMutex;
+        utils::LruCache<uintptr_t, CachedSymbol> m_cache;
+        uint32_t m_cacheVersion = 0; // Version of the symbol tables the cached results were resolved with
+        std::atomic<uint64_t> m_cacheHits = 0;
+        std::atomic<uint64_t> m_cacheMisses = 0;
+    };
+
+}
@@ -0,0 +1,74 @@
+#include "symbol-service.hpp"
+
+#include <Windows.h>
+
+#include "symbol-resolver.hpp"
+
+namespace analyzer {
+
+    SymbolService &SymbolService::get() {
+        // Never destroyed, since the service thread keeps running until the process exits
+        static auto service = new SymbolService();
+        return *service;
+    }
+
+    void SymbolService::start() {
+        std::lock_guard lock(m_mutex);
+        if (m_threadId != std::thread::id()) return;
+
+        std::thread thread([this] { serviceLoop(); });
+        m_threadId = thread.get_id();
+        thread.detach();
+    }
+
+    bool SymbolService::isServiceThread() const {
+        std::lock_guard lock(m_mutex);
+        return m_threadId == std::this_thread::get_id();
+    }
+
+    void SymbolService::enqueue(std::function<void()> job) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_threadId != std::thread::id() && m_threadId != std::this_thread::get_id()) {
+                m_jobs.push_back(std::move(job));
+                m_wake.notify_one();
+                return;
+            }
+        }
+
+        std::lock_guard lock(m_inlineMutex);
+        job();
+    }
+
+    void SymbolService::serviceLoop() {
+        SetThreadDescription(GetCurrentThread(), L"BetterCrashlogs Symbols");
+
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [&] { return !m_jobs.empty(); });
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            // Jobs that were started inline before the thread existed might still be running
+            std::lock_guard lock(m_inlineMutex);
+            job();
+        }
+    }
+
+    std::future<std::vector<MethodInfo>> SymbolService::resolve(std::vector<uintptr_t> addresses, bool withLine) {
+        return submit([addresses = std::move(addresses), withLine] {
+            auto &resolver = SymbolResolver::get();
+
+            std::vector<MethodInfo> functions;
+            functions.reserve(addresses.size());
+            for (auto address: addresses) {
+                functions.push_back(resolver.resolve(address, withLine));
+            }
+            return functions;
+        });
+    }
+
+}
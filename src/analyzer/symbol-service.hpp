@@ -0,0 +1,72 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "analyzer.hpp"
+
+namespace analyzer {
+
+    /// @brief Thread that owns all DbgHelp calls.
+    /// DbgHelp is single-threaded, so instead of locking it from every caller, calls are queued as jobs and run
+    /// one after another on the service thread. Callers get a future, so they can keep drawing (or submit more
+    /// work) while the symbols are loaded.
+    /// @note Jobs submitted from the service thread itself run immediately, so a job can use the service too.
+    class SymbolService {
+    public:
+        /// @brief Get the process-wide service.
+        static SymbolService &get();
+
+        /// @brief Start the service thread, if it is not running yet.
+        /// Until then, jobs run on the calling thread (one at a time).
+        void start();
+
+        /// @brief Whether the calling thread is the one running the jobs.
+        [[nodiscard]] bool isServiceThread() const;
+
+        /// @brief Queue a job.
+        /// @return Future with the result of the job.
+        template <typename Job>
+        std::future<std::invoke_result_t<Job>> submit(Job &&job) {
+            using Result = std::invoke_result_t<Job>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Job>(job));
+            auto future = task->get_future();
+            enqueue([task] { (*task)(); });
+            return future;
+        }
+
+        /// @brief Run a job and wait for its result.
+        template <typename Job>
+        std::invoke_result_t<Job> call(Job &&job) {
+            if (isServiceThread()) return job();
+            return submit(std::forward<Job>(job)).get();
+        }
+
+        /// @brief Resolve the addresses in a single job (see SymbolResolver::resolve).
+        /// @return Future with the functions, in the same order as the addresses.
+        std::future<std::vector<MethodInfo>> resolve(std::vector<uintptr_t> addresses, bool withLine = false);
+
+    private:
+        SymbolService() = default;
+
+        /// @brief Run the job on the service thread, or right away if there is none or this is the one.
+        void enqueue(std::function<void()> job);
+
+        void serviceLoop();
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::deque<std::function<void()>> m_jobs;
+        std::thread::id m_threadId; // Default (no thread) until started
+        std::recursive_mutex m_inlineMutex; // Serializes jobs run on the calling threads before the start
+    };
+
+}
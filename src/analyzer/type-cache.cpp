@@ -0,0 +1,95 @@
+#include "type-cache.hpp"
+
+#include <typeinfo>
+
+#include "../utils/memory.hpp"
+#include "../utils/string-arena.hpp"
+
+namespace analyzer {
+
+    /// @brief Any polymorphic type, so that `typeid` reads the RTTI through the vtable of the object.
+    struct Polymorphic {
+        virtual ~Polymorphic() = default;
+    };
+
+    /// @brief Read the vtable pointer of an object.
+    /// @return The vtable address, or 0 if the object can't be read.
+    static uintptr_t readVTable(uintptr_t address) {
+        if (utils::mem::getReadableSize(address, sizeof(uintptr_t)) < sizeof(uintptr_t)) {
+            return 0;
+        }
+
+        __try {
+            return *reinterpret_cast<const uintptr_t *>(address);
+        } __except(EXCEPTION_EXECUTE_HANDLER) {
+            return 0;
+        }
+    }
+
+    /// @brief Get the raw RTTI name of an object (e.g. "class cocos2d::CCNode").
+    /// @return The name, or nullptr if the vtable doesn't have a valid object locator.
+    static const char *readRawTypeName(uintptr_t address) {
+        __try {
+            return typeid(*reinterpret_cast<Polymorphic *>(address)).name();
+        } __except(EXCEPTION_EXECUTE_HANDLER) {
+            return nullptr;
+        }
+    }
+
+    TypeCache &TypeCache::get() {
+        static TypeCache cache;
+        return cache;
+    }
+
+    TypeCache::TypeCache() {
+        ModuleRegistry::get().addUnloadListener([this](const ModuleInfo &module) {
+            invalidate(module);
+        });
+    }
+
+    void TypeCache::invalidate(const ModuleInfo &module) {
+        std::lock_guard lock(m_mutex);
+        m_cache.eraseIf([&](uintptr_t vtable, const std::optional<std::string_view> &) {
+            return vtable >= module.baseAddress && vtable - module.baseAddress < module.size;
+        });
+    }
+
+    void TypeCache::clear() {
+        std::lock_guard lock(m_mutex);
+        m_cache.clear();
+    }
+
+    std::optional<std::string_view> TypeCache::readTypeName(uintptr_t address) {
+        auto type = readRawTypeName(address);
+        if (!type) return std::nullopt;
+
+        auto length = utils::mem::getStringLength((uintptr_t) type);
+        if (!length) return std::nullopt;
+
+        // Only classes are interesting, and "class " is not part of the displayed name
+        constexpr std::string_view prefix = "class ";
+        std::string_view name(type, *length);
+        if (!name.starts_with(prefix)) return std::nullopt;
+
+        return utils::internSymbol(name.substr(prefix.size()));
+    }
+
+    std::optional<std::string_view> TypeCache::getTypeName(uintptr_t address) {
+        auto vtable = readVTable(address);
+        if (vtable == 0) return std::nullopt;
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (auto cached = m_cache.get(vtable)) {
+                return *cached;
+            }
+        }
+
+        auto name = readTypeName(address);
+
+        std::lock_guard lock(m_mutex);
+        m_cache.put(vtable, name);
+        return name;
+    }
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string_view>
+
+#include "module-registry.hpp"
+#include "../utils/lru-cache.hpp"
+
+namespace analyzer {
+
+    /// @brief Class names of polymorphic objects, cached by their vtable.
+    /// Objects of the same class share a vtable, so RTTI is only parsed once per class.
+    class TypeCache {
+    public:
+        /// @brief Amount of vtables to remember (including values that turned out not to be vtables).
+        static constexpr size_t CAPACITY = 1024;
+
+        /// @brief Get the process-wide cache.
+        static TypeCache &get();
+
+        /// @brief Get the class name of an object.
+        /// @param address The address of the object
+        /// @return The class name (e.g. "cocos2d::CCNode", interned in the analysis arena),
+        /// or std::nullopt if the object has no RTTI.
+        std::optional<std::string_view> getTypeName(uintptr_t address);
+
+        /// @brief Drop the cached vtables inside the module.
+        void invalidate(const ModuleInfo &module);
+
+        /// @brief Drop all cached vtables (the names are freed with the analysis arena).
+        void clear();
+
+    private:
+        TypeCache();
+
+        /// @brief Parse the RTTI of the vtable, without looking at the cache.
+        static std::optional<std::string_view> readTypeName(uintptr_t address);
+
+        std::mutex m_mutex;
+        utils::LruCache<uintptr_t, std::optional<std::string_view>> m_cache{CAPACITY};
+    };
+
+}
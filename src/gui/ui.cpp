@@ -31,6 +31,22 @@ namespace ui {
             {"hookhandler", IM_COL32(200, 200, 200, 255)}, /* greyish */
     };
 
+    /// @brief Show a pointer chain one hop per line, when the value is hovered.
+    static void pointerChainTooltip(analyzer::ValueType type, const std::string &description) {
+        if (type != analyzer::ValueType::Pointer || !ImGui::IsItemHovered()) return;
+
+        std::string chain;
+        size_t start = 0;
+        while (true) {
+            auto next = description.find(" -> ", start);
+            chain.append(description, start, next - start);
+            if (next == std::string::npos) break;
+            chain += "\n";
+            start = next + 1;
+        }
+        ImGui::SetTooltip("%s", chain.c_str());
+    }
+
     static int quoteIndex = -1; // -1 means uninitialized (we can reset to -1 to pick a new quote)
 
     const char *pickRandomQuote() {
@@ -186,6 +202,7 @@ namespace ui {
                             ImGui::PushStyleColor(ImGuiCol_Text, colorMap["function"]);
                             break;
                         case analyzer::ValueType::String:
+                        case analyzer::ValueType::WideString:
                             ImGui::PushStyleColor(ImGuiCol_Text, colorMap["string"]);
                             break;
                         case analyzer::ValueType::CCObject:
@@ -196,6 +213,7 @@ namespace ui {
                             break;
                     }
                     ImGui::Text("%s", reg.description.c_str());
+                    pointerChainTooltip(reg.type, reg.description);
                     ImGui::PopStyleColor();
                 }
 
@@ -338,7 +356,22 @@ namespace ui {
     void stackWindow(analyzer::Analyzer& analyzer) {
         if (ImGui::Begin("Stack Allocations")) {
 
-            auto stackAlloc = analyzer.getStackData();
+            // The whole stack is too large to classify at once, so it is shown one page at a time
+            static size_t stackPage = 0;
+            auto pageCount = std::max<size_t>(analyzer.getStackPageCount(), 1);
+            stackPage = std::min(stackPage, pageCount - 1);
+
+            if (ImGui::ArrowButton("##prev", ImGuiDir_Left) && stackPage > 0) {
+                stackPage--;
+            }
+            ImGui::SameLine();
+            if (ImGui::ArrowButton("##next", ImGuiDir_Right) && stackPage + 1 < pageCount) {
+                stackPage++;
+            }
+            ImGui::SameLine();
+            ImGui::Text("Page %zu / %zu (%zu values)", stackPage + 1, pageCount, analyzer.getStackSize());
+
+            auto stackAlloc = analyzer.getStackPage(stackPage);
 
             // Create a table with the stack trace
             ImGui::BeginTable("stack", 3,
@@ -350,7 +383,7 @@ namespace ui {
             ImGui::TableHeadersRow();
 
             int i = 0;
-            for (const auto &line: stackAlloc) {
+            for (const auto &line: *stackAlloc) {
                 ImGui::TableNextRow();
                 ImGui::TableNextColumn();
 
@@ -378,6 +411,7 @@ namespace ui {
                         ImGui::PushStyleColor(ImGuiCol_Text, colorMap["function"]);
                         break;
                     case analyzer::ValueType::String:
+                    case analyzer::ValueType::WideString:
                         ImGui::PushStyleColor(ImGuiCol_Text, colorMap["string"]);
                         break;
                     case analyzer::ValueType::CCObject:
@@ -388,6 +422,7 @@ namespace ui {
                         break;
                 }
                 ImGui::Text("%s", line.description.c_str());
+                pointerChainTooltip(line.type, line.description);
                 ImGui::PopStyleColor();
             }
 
@@ -455,14 +490,26 @@ namespace ui {
                     COPY_POPUP(functionStr.c_str(), functionStr.c_str());
                     ImGui::PopStyleColor();
 
-                    if (!line.function.file.empty()) {
+                    // Only expanded frames are shown, so only their source lines are looked up
+                    auto source = analyzer.getSourceLine(line.address);
+                    if (source.state == analyzer::SourceLineState::Resolving) {
+                        ImGui::PushStyleColor(ImGuiCol_Text, colorMap["primary"]);
+                        ImGui::Text("File");
+                        ImGui::PopStyleColor();
+
+                        ImGui::SameLine();
+
+                        ImGui::PushStyleColor(ImGuiCol_Text, colorMap["hookhandler"]);
+                        ImGui::Text("resolving...");
+                        ImGui::PopStyleColor();
+                    } else if (!source.file.empty()) {
                         ImGui::PushStyleColor(ImGuiCol_Text, colorMap["primary"]);
                         ImGui::Text("File");
                         ImGui::PopStyleColor();
 
                         ImGui::SameLine();
 
-                        auto lineStr = fmt::format("{}:{}", line.function.file, line.function.line);
+                        auto lineStr = fmt::format("{}:{}", source.file, source.line);
                         ImGui::PushStyleColor(ImGuiCol_Text, colorMap["string"]);
                         ImGui::Text("%s", lineStr.c_str());
                         ImGui::PopStyleColor();
@@ -495,6 +542,44 @@ namespace ui {
                     ImGui::TreePop();
                 }
                 ImGui::PopStyleColor();
+
+                // Recursion and long traces are collapsed by the analyzer
+                if (line.repeatCount > 0) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, colorMap["hookhandler"]);
+                    ImGui::Text("  (last %zu frame(s) repeated %zu more times)", line.repeatLength, line.repeatCount);
+                    ImGui::PopStyleColor();
+                }
+                if (line.skippedFrames > 0) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, colorMap["hookhandler"]);
+                    ImGui::Text("  ... %zu frames omitted", line.skippedFrames);
+                    ImGui::PopStyleColor();
+                }
+            }
+
+            // Frames that StackWalk64 missed, found by looking for return addresses on the stack
+            const auto &probableFrames = analyzer.getProbableFrames();
+            if (!probableFrames.empty()) {
+                ImGui::Separator();
+                ImGui::PushStyleColor(ImGuiCol_Text, colorMap["primary"]);
+                ImGui::Text("Probable frames (found by scanning the stack)");
+                ImGui::PopStyleColor();
+
+                for (const auto &line: probableFrames) {
+                    auto functionStr = line.function.toString();
+                    ImGui::PushStyleColor(ImGuiCol_Text, colorMap["white"]);
+                    ImGui::Text("- %s", functionStr.c_str());
+                    if (ImGui::IsItemHovered()) {
+                        ImGui::SetTooltip("Return address found at 0x%08llX", line.framePointer);
+                    }
+                    if (ImGui::BeginPopupContextItem(fmt::format("probable_{:X}", line.framePointer).c_str())) {
+                        if (ImGui::MenuItem("Copy")) {
+                            ImGui::SetClipboardText(functionStr.c_str());
+                            showToast(fmt::format("Copied {}", functionStr));
+                        }
+                        ImGui::EndPopup();
+                    }
+                    ImGui::PopStyleColor();
+                }
             }
 
         }
@@ -531,7 +616,7 @@ namespace ui {
             ImGui::TableHeadersRow();
 
             for (int i = 0; i < assembly.size(); i++) {
-                auto ins = assembly[i];
+                const auto &ins = assembly[i];
                 ImGui::TableNextRow();
 
                 // Color the row red if the address is the next instruction
@@ -549,14 +634,19 @@ namespace ui {
 
                 ImGui::TableNextColumn();
 
+                // Formatted into stack buffers, so drawing doesn't allocate
+                char bytes[disasm::BYTES_TEXT_SIZE];
+                ins.formatBytes(bytes, sizeof(bytes));
                 ImGui::PushStyleColor(ImGuiCol_Text, colorMap["primary"]);
-                ImGui::Text("%s", ins.bytes.c_str());
+                ImGui::Text("%s", bytes);
                 ImGui::PopStyleColor();
 
                 ImGui::TableNextColumn();
 
+                char text[disasm::INSTRUCTION_TEXT_SIZE];
+                ins.formatText(text, sizeof(text));
                 ImGui::PushStyleColor(ImGuiCol_Text, colorMap["white"]);
-                ImGui::Text("%s", ins.text.c_str());
+                ImGui::Text("%s", text);
                 ImGui::PopStyleColor();
             }
 
@@ -10,32 +10,38 @@
 #include "utils/utils.hpp"
 #include "analyzer/exception-codes.hpp"
 #include "analyzer/disassembler.hpp"
+#include "analyzer/symbol-service.hpp"
 #include "analyzer/4gb_patch.hpp"
 #include "utils/config.hpp"
+#include "utils/crash-index.hpp"
 #include "utils/memory.hpp"
 #include "utils/hwinfo.hpp"
+#include "utils/preload.hpp"
 
 #define LOG_WRAP(message, ...) geode::log::info("Getting " message); __VA_ARGS__
 
 std::string getCrashReport(analyzer::Analyzer& analyzer) {
     auto currentDateTime = utils::getCurrentDateTime();
     auto randomQuote = ui::pickRandomQuote();
+    LOG_WRAP("Fingerprint", auto fingerprint = analyzer.getFingerprint());
     LOG_WRAP("Loader Metadata", auto loaderMetadata = utils::geode::getLoaderMetadataMessage());
     LOG_WRAP("Exception Info", auto exceptionInfo = analyzer.getExceptionMessage());
     LOG_WRAP("Stack Trace", auto stackTrace = analyzer.getStackTraceMessage());
+    LOG_WRAP("Probable Frames", auto probableFrames = analyzer.getProbableFramesMessage());
     LOG_WRAP("Register States", auto registerStates = analyzer.getRegisterStateMessage());
     LOG_WRAP("Installed Mods", auto installedMods = utils::geode::getModListMessage());
     LOG_WRAP("Stack Allocations", auto stackAllocations = analyzer.getStackAllocationsMessage());
     LOG_WRAP("Hardware Information", auto hardwareInfo = hwinfo::getMessage());
+    LOG_WRAP("Diagnostics", auto diagnostics = analyzer.getDiagnosticsMessage());
 
     return fmt::format(
-            "{}\n{}\n\n"
+            "{}\n{}\nFingerprint: {:016X}\n\n"
             "== Geode Information ==\n"
             "{}\n\n"
             "== Exception Information ==\n"
             "{}\n\n"
             "== Stack Trace ==\n"
-            "{}\n\n"
+            "{}{}\n\n"
             "== Register States ==\n"
             "{}\n\n"
             "== Installed Mods ==\n"
@@ -43,12 +49,16 @@ std::string getCrashReport(analyzer::Analyzer& analyzer) {
             "== Stack Allocations ==\n"
             "{}\n\n"
             "== Hardware Information ==\n"
+            "{}\n\n"
+            "== Diagnostics ==\n"
             "{}",
-            currentDateTime, randomQuote,
+            currentDateTime, randomQuote, fingerprint,
             loaderMetadata, exceptionInfo,
-            stackTrace, registerStates,
+            stackTrace,
+            probableFrames.empty() ? "" : fmt::format("\n\nProbable frames (found by scanning the stack):\n{}", probableFrames),
+            registerStates,
             installedMods, stackAllocations,
-            hardwareInfo
+            hardwareInfo, diagnostics
     );
 }
 
@@ -124,6 +134,12 @@ LONG WINAPI HandleCrash(LPEXCEPTION_POINTERS ExceptionInfo) {
         saved = true;
         geode::log::info("Crash information saved to: {}", crashReportPath.string());
 
+        // Group the crash with the earlier ones that have the same cause
+        utils::CrashIndex crashIndex(crashReportDir);
+        if (auto bucket = crashIndex.record(analyzer.getFingerprint(), crashReportPath.filename().string(), time(nullptr))) {
+            geode::log::info("Crash fingerprint {:016X} was seen {} time(s)", bucket->fingerprint, bucket->count);
+        }
+
         // Create empty "last-crashed" file to indicate that the game crashed
         std::ofstream lastCrashedFile(crashReportDir / "last-crashed");
         lastCrashedFile.close();
@@ -205,10 +221,10 @@ LONG WINAPI HandleCrash(LPEXCEPTION_POINTERS ExceptionInfo) {
 
                 // Get the current instruction and increment the program counter
 #ifndef _WIN64
-                auto &instruction = disasm::disassemble(ExceptionInfo->ContextRecord->Eip);
+                auto instruction = disasm::disassemble(ExceptionInfo->ContextRecord->Eip);
                 ExceptionInfo->ContextRecord->Eip += instruction.size;
 #else
-                auto &instruction = disasm::disassemble(ExceptionInfo->ContextRecord->Rip);
+                auto instruction = disasm::disassemble(ExceptionInfo->ContextRecord->Rip);
                 ExceptionInfo->ContextRecord->Rip += instruction.size;
 #endif
 
@@ -375,12 +391,26 @@ static void updateFile(const std::string& filename) {
             auto data = res->string().unwrapOr("");
             if (data.empty()) return;
 
+            // Write to a temporary file first, so a crash never sees a half-written file
             auto path = utils::geode::getConfigPath() / filename;
-            std::ofstream file(path);
+            auto tempPath = path;
+            tempPath += ".tmp";
+            std::ofstream file(tempPath, std::ios::binary);
             file << data;
             file.close();
+            if (!file || !utils::geode::replaceFile(tempPath, path)) {
+                geode::log::warn("Failed to save {}", filename);
+                return;
+            }
 
             geode::log::info("Successfully downloaded {} to {}", filename, path.string());
+
+            // Precompile the symbols and publish the new table off the main thread
+            bool isCocos = filename == utils::geode::getCocosFile();
+            std::thread([isCocos] {
+                SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+                utils::geode::reloadFunctionAddresses(isCocos);
+            }).detach();
         },
         [](auto){}, []{}
     );
@@ -416,6 +446,12 @@ $execute {
     geode::log::info("Setting up crash handler...");
     SetUnhandledExceptionFilter(ExceptionHandler);
 
+    // Prepare symbols and static report sections in the background once the game is running
+    geode::queueInMainThread([] {
+        utils::preload::start();
+        analyzer::SymbolService::get().start();
+    });
+
     if (utils::geode::intrusiveEnabled()) {
         geode::queueInMainThread([] {
             geode::log::info("Intrusive mode enabled, setting up continue handler...");
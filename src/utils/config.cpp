@@ -16,7 +16,8 @@ namespace config {
             50, 50, 1280, 720,
             false, 1.f, 0,
             true, true, true,
-            true, true, true, true
+            true, true, true, true,
+            "", 0, 0
         };
         if (!loaded) {
             loaded = true;
@@ -56,6 +57,9 @@ namespace config {
             else if (key == "show_stack") config.show_stack = value == "true";
             else if (key == "show_stacktrace") config.show_stacktrace = value == "true";
             else if (key == "show_disassembly") config.show_disassembly = value == "true";
+            else if (key == "symbol_providers") config.symbol_providers = value;
+            else if (key == "symbol_cache_size") config.symbol_cache_size = std::stoi(value);
+            else if (key == "stack_depth") config.stack_depth = std::stoi(value);
         }
 
         file.close();
@@ -79,6 +83,9 @@ namespace config {
         file << "show_stack=" << (config.show_stack ? "true" : "false") << "\n";
         file << "show_stacktrace=" << (config.show_stacktrace ? "true" : "false") << "\n";
         file << "show_disassembly=" << (config.show_disassembly ? "true" : "false") << "\n";
+        file << "symbol_providers=" << config.symbol_providers << "\n";
+        file << "symbol_cache_size=" << config.symbol_cache_size << "\n";
+        file << "stack_depth=" << config.stack_depth << "\n";
 
         file.close();
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <ctime>
+#include <string>
 
 namespace config {
 
@@ -19,6 +20,9 @@ namespace config {
         bool show_stack;
         bool show_stacktrace;
         bool show_disassembly;
+        std::string symbol_providers; // Comma-separated order of the symbol providers (empty = default)
+        int symbol_cache_size; // Amount of resolved addresses to keep (0 = default)
+        int stack_depth; // Amount of stack values included in the report (0 = default)
     };
 
     void load();
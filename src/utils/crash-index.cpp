@@ -0,0 +1,235 @@
+#include "crash-index.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+namespace utils {
+
+    static constexpr char INDEX_MAGIC[4] = {'B', 'C', 'L', 'B'};
+    static constexpr uint32_t MAX_PATH_LENGTH = 4096;
+
+    static std::streamoff getSlotOffset(uint32_t slot) {
+        return static_cast<std::streamoff>(sizeof(CrashIndex::IndexHeader) + slot * sizeof(CrashIndex::Bucket));
+    }
+
+    /// @brief Read the log records of a bucket, most recent first.
+    /// @return Pairs of the crash time and the file name.
+    static std::vector<std::pair<int64_t, std::string>> readRecords(std::istream &log, const CrashIndex::Bucket &bucket,
+                                                                    size_t limit) {
+        std::vector<std::pair<int64_t, std::string>> records;
+
+        // Records only point backwards, so a corrupted log can't make this loop forever
+        uint64_t next = bucket.lastRecord;
+        while (next != 0 && records.size() < limit) {
+            CrashIndex::LogRecord record{};
+            log.clear();
+            log.seekg(static_cast<std::streamoff>(next - 1));
+            if (!log.read(reinterpret_cast<char *>(&record), sizeof(record))) break;
+            if (record.fingerprint != bucket.fingerprint || record.previous >= next || record.nameLength > MAX_PATH_LENGTH) {
+                break;
+            }
+
+            std::string name(record.nameLength, '\0');
+            if (!log.read(name.data(), record.nameLength)) break;
+            records.emplace_back(record.time, std::move(name));
+            next = record.previous;
+        }
+        return records;
+    }
+
+    CrashIndex::CrashIndex(std::filesystem::path directory, uint64_t maxLogSize)
+            : m_indexPath(directory / "buckets.idx"), m_logPath(directory / "buckets.log"), m_maxLogSize(maxLogSize) {}
+
+    bool CrashIndex::prepare() const {
+        {
+            std::ifstream file(m_indexPath, std::ios::binary);
+            IndexHeader header{};
+            if (file.read(reinterpret_cast<char *>(&header), sizeof(header))
+                && std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0
+                && header.version == INDEX_VERSION && header.slotCount == SLOT_COUNT) {
+                return true;
+            }
+        }
+
+        // The log is useless without the index
+        std::error_code error;
+        std::filesystem::create_directories(m_indexPath.parent_path(), error);
+        std::filesystem::remove(m_logPath, error);
+
+        std::ofstream file(m_indexPath, std::ios::binary | std::ios::trunc);
+        IndexHeader header{};
+        std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        header.version = INDEX_VERSION;
+        header.slotCount = SLOT_COUNT;
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        std::vector<Bucket> slots(SLOT_COUNT);
+        file.write(reinterpret_cast<const char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Bucket)));
+        return file.good();
+    }
+
+    std::optional<CrashIndex::Bucket> CrashIndex::record(uint64_t fingerprint, std::string_view fileName, time_t time) {
+        if (fingerprint == 0 || !prepare()) return std::nullopt;
+
+        std::fstream index(m_indexPath, std::ios::binary | std::ios::in | std::ios::out);
+        if (!index) return std::nullopt;
+
+        // Find the bucket, or the slot to put it in (an empty one, or else the least recently seen one)
+        uint32_t target = 0;
+        Bucket bucket{};
+        Bucket victim{};
+        bool found = false;
+        for (uint32_t probe = 0; probe < MAX_PROBES; probe++) {
+            uint32_t slot = static_cast<uint32_t>((fingerprint + probe) % SLOT_COUNT);
+            Bucket current{};
+            index.seekg(getSlotOffset(slot));
+            if (!index.read(reinterpret_cast<char *>(&current), sizeof(current))) return std::nullopt;
+
+            if (current.fingerprint == fingerprint) {
+                target = slot;
+                bucket = current;
+                found = true;
+                break;
+            }
+            if (current.fingerprint == 0) {
+                target = slot;
+                victim = current;
+                break;
+            }
+            if (probe == 0 || current.lastSeen < victim.lastSeen) {
+                target = slot;
+                victim = current;
+            }
+        }
+
+        if (!found) {
+            bucket = {};
+            bucket.fingerprint = fingerprint;
+            bucket.firstSeen = time;
+        }
+
+        // Append the file name to the log
+        uint64_t logSize = 0;
+        std::ofstream log(m_logPath, std::ios::binary | std::ios::app);
+        if (log) {
+            log.seekp(0, std::ios::end);
+            auto offset = static_cast<uint64_t>(log.tellp());
+            LogRecord record{};
+            record.fingerprint = fingerprint;
+            record.previous = bucket.lastRecord;
+            record.time = time;
+            record.nameLength = static_cast<uint32_t>(fileName.size());
+            log.write(reinterpret_cast<const char *>(&record), sizeof(record));
+            log.write(fileName.data(), static_cast<std::streamsize>(fileName.size()));
+            if (log.good()) {
+                bucket.lastRecord = offset + 1;
+                logSize = offset + sizeof(record) + fileName.size();
+            }
+        }
+        log.close();
+
+        bucket.count++;
+        bucket.lastSeen = time;
+
+        index.seekp(getSlotOffset(target));
+        index.write(reinterpret_cast<const char *>(&bucket), sizeof(bucket));
+        if (!index.good()) return std::nullopt;
+        index.close();
+
+        if (logSize > m_maxLogSize && compact()) {
+            return find(fingerprint);
+        }
+        return bucket;
+    }
+
+    std::optional<CrashIndex::Bucket> CrashIndex::find(uint64_t fingerprint) const {
+        if (fingerprint == 0) return std::nullopt;
+
+        std::ifstream index(m_indexPath, std::ios::binary);
+        IndexHeader header{};
+        if (!index.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.slotCount != SLOT_COUNT) {
+            return std::nullopt;
+        }
+
+        for (uint32_t probe = 0; probe < MAX_PROBES; probe++) {
+            Bucket bucket{};
+            index.seekg(getSlotOffset(static_cast<uint32_t>((fingerprint + probe) % SLOT_COUNT)));
+            if (!index.read(reinterpret_cast<char *>(&bucket), sizeof(bucket))) return std::nullopt;
+            if (bucket.fingerprint == fingerprint) return bucket;
+            if (bucket.fingerprint == 0) break;
+        }
+        return std::nullopt;
+    }
+
+    std::vector<std::string> CrashIndex::getFiles(const Bucket &bucket) const {
+        std::vector<std::string> files;
+        std::ifstream log(m_logPath, std::ios::binary);
+        if (!log) return files;
+
+        for (auto &[time, name]: readRecords(log, bucket, bucket.count)) {
+            files.push_back(std::move(name));
+        }
+        return files;
+    }
+
+    bool CrashIndex::compact() {
+        if (!prepare()) return false;
+
+        std::fstream index(m_indexPath, std::ios::binary | std::ios::in | std::ios::out);
+        std::ifstream log(m_logPath, std::ios::binary);
+        if (!index || !log) return false;
+
+        std::vector<Bucket> slots(SLOT_COUNT);
+        index.seekg(getSlotOffset(0));
+        if (!index.read(reinterpret_cast<char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Bucket)))) {
+            return false;
+        }
+
+        // Write the new log next to the old one, so a failure leaves the index consistent
+        auto compactedPath = m_logPath;
+        compactedPath += ".tmp";
+        std::error_code error;
+        {
+            std::ofstream compacted(compactedPath, std::ios::binary | std::ios::trunc);
+            uint64_t offset = 0;
+            for (auto &bucket: slots) {
+                if (bucket.fingerprint == 0) continue;
+
+                auto records = readRecords(log, bucket, MAX_FILES_PER_BUCKET);
+                bucket.lastRecord = 0;
+
+                // Oldest first, so every record still points backwards
+                for (auto it = records.rbegin(); it != records.rend(); ++it) {
+                    LogRecord record{};
+                    record.fingerprint = bucket.fingerprint;
+                    record.previous = bucket.lastRecord;
+                    record.time = it->first;
+                    record.nameLength = static_cast<uint32_t>(it->second.size());
+                    compacted.write(reinterpret_cast<const char *>(&record), sizeof(record));
+                    compacted.write(it->second.data(), static_cast<std::streamsize>(it->second.size()));
+                    bucket.lastRecord = offset + 1;
+                    offset += sizeof(record) + it->second.size();
+                }
+            }
+
+            if (!compacted.good()) {
+                compacted.close();
+                std::filesystem::remove(compactedPath, error);
+                return false;
+            }
+        }
+
+        log.close();
+        std::filesystem::rename(compactedPath, m_logPath, error);
+        if (error) {
+            std::filesystem::remove(compactedPath, error);
+            return false;
+        }
+
+        index.seekp(getSlotOffset(0));
+        index.write(reinterpret_cast<const char *>(slots.data()), static_cast<std::streamsize>(slots.size() * sizeof(Bucket)));
+        return index.good();
+    }
+
+}
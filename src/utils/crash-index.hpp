@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace utils {
+
+    /// @brief On-disk index of crash fingerprints, so crashes with the same cause can be grouped.
+    /// The index is a fixed-size hash table file ("buckets.idx"), and the crashlog file names are kept in an
+    /// append-only log ("buckets.log") as a linked list per bucket. Recording a crash touches a constant amount
+    /// of data, no matter how many crashes were recorded before.
+    /// Once the log grows past a size limit, it is rewritten with only the most recent names of every bucket.
+    class CrashIndex {
+    public:
+        struct Bucket {
+            uint64_t fingerprint; // 0 = empty slot
+            uint32_t count; // Amount of recorded crashes
+            uint32_t reserved;
+            int64_t firstSeen; // Unix time of the first crash
+            int64_t lastSeen; // Unix time of the last crash
+            uint64_t lastRecord; // Offset of the last log record + 1, or 0 if there is none
+        };
+
+        /// @brief Header of the index file, followed by `slotCount` buckets.
+        struct IndexHeader {
+            char magic[4]; // "BCLB"
+            uint32_t version; // INDEX_VERSION
+            uint32_t slotCount;
+            uint32_t reserved;
+        };
+
+        /// @brief Record in the log file, followed by `nameLength` bytes of the file name.
+        struct LogRecord {
+            uint64_t fingerprint;
+            uint64_t previous; // Offset of the previous record of the bucket + 1, or 0
+            int64_t time;
+            uint32_t nameLength;
+            uint32_t reserved;
+        };
+
+        static constexpr uint32_t INDEX_VERSION = 1;
+        static constexpr uint32_t SLOT_COUNT = 1024;
+
+        /// @brief Amount of slots checked for a fingerprint, before the least recent bucket is replaced.
+        static constexpr uint32_t MAX_PROBES = 16;
+
+        /// @brief Amount of crashlog names kept per bucket when the log is compacted.
+        static constexpr uint32_t MAX_FILES_PER_BUCKET = 16;
+
+        /// @brief Size of the log file above which it is compacted.
+        static constexpr uint64_t MAX_LOG_SIZE = 4 * 1024 * 1024;
+
+        /// @param directory Directory of the index files
+        /// @param maxLogSize Size of the log file above which it is compacted
+        explicit CrashIndex(std::filesystem::path directory, uint64_t maxLogSize = MAX_LOG_SIZE);
+
+        /// @brief Record a crash.
+        /// @param fingerprint The crash fingerprint (must not be 0)
+        /// @param fileName Name of the crashlog file
+        /// @param time Time of the crash
+        /// @return The updated bucket, or std::nullopt if the index couldn't be written.
+        std::optional<Bucket> record(uint64_t fingerprint, std::string_view fileName, time_t time);
+
+        /// @brief Find the bucket of a fingerprint.
+        [[nodiscard]] std::optional<Bucket> find(uint64_t fingerprint) const;
+
+        /// @brief Get the crashlog file names of a bucket, most recent first.
+        [[nodiscard]] std::vector<std::string> getFiles(const Bucket &bucket) const;
+
+        /// @brief Rewrite the log with only the most recent `MAX_FILES_PER_BUCKET` names of every bucket,
+        /// dropping the records of replaced buckets. Called by `record` once the log is larger than the limit.
+        /// @return Whether the log was rewritten.
+        bool compact();
+
+    private:
+        /// @brief Create an empty index file, if it is missing or has a different layout.
+        bool prepare() const;
+
+        std::filesystem::path m_indexPath;
+        std::filesystem::path m_logPath;
+        uint64_t m_maxLogSize;
+    };
+
+}
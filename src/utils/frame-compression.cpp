@@ -0,0 +1,95 @@
+#include "frame-compression.hpp"
+
+#include <algorithm>
+
+namespace utils {
+
+    std::vector<FrameRun> compressFrames(std::span<const RawFrame> frames) {
+        std::vector<FrameRun> runs;
+        size_t i = 0;
+        while (i < frames.size()) {
+            size_t bestLength = 1;
+            size_t bestRepeats = 0;
+            for (size_t length = 1; length <= MAX_CYCLE_LENGTH && i + length * 2 <= frames.size(); length++) {
+                size_t repeats = 0;
+                while (i + length * (repeats + 2) <= frames.size()) {
+                    auto cycle = frames.begin() + i;
+                    auto next = cycle + length * (repeats + 1);
+                    auto same = std::equal(cycle, cycle + length, next, [](const RawFrame &a, const RawFrame &b) {
+                        return a.address == b.address;
+                    });
+                    if (!same) break;
+                    repeats++;
+                }
+
+                if (repeats > 0 && length * (repeats + 1) > bestLength * (bestRepeats + 1)) {
+                    bestLength = length;
+                    bestRepeats = repeats;
+                }
+            }
+
+            if (bestRepeats == 0) {
+                // Merge consecutive plain frames into a single run
+                if (!runs.empty() && runs.back().repeats == 0 && runs.back().first + runs.back().length == i) {
+                    runs.back().length++;
+                } else {
+                    runs.push_back({i, 1, 0});
+                }
+                i++;
+                continue;
+            }
+
+            runs.push_back({i, bestLength, bestRepeats});
+            i += bestLength * (bestRepeats + 1);
+        }
+        return runs;
+    }
+
+    std::vector<KeptFrame> selectFrames(std::span<const FrameRun> runs, size_t keep) {
+        size_t lineCount = 0;
+        for (const auto &run: runs) {
+            lineCount += run.length;
+        }
+        size_t headEnd = lineCount > keep * 2 ? keep : lineCount;
+        size_t tailStart = lineCount > keep * 2 ? lineCount - keep : lineCount;
+
+        std::vector<KeptFrame> kept;
+        size_t line = 0;
+        size_t skipped = 0;
+        auto add = [&](size_t index) {
+            if (skipped > 0 && !kept.empty()) {
+                kept.back().skippedFrames = skipped;
+            }
+            skipped = 0;
+            kept.push_back({index, 0, 0, 0});
+        };
+
+        for (const auto &run: runs) {
+            if (run.repeats > 0) {
+                // A cycle has at most MAX_CYCLE_LENGTH lines, so keeping it whole barely grows the trace
+                if (line < headEnd || line + run.length > tailStart) {
+                    for (size_t j = 0; j < run.length; j++) {
+                        add(run.first + j);
+                    }
+                    kept.back().repeatLength = run.length;
+                    kept.back().repeatCount = run.repeats;
+                } else {
+                    skipped += run.length * (run.repeats + 1);
+                }
+                line += run.length;
+                continue;
+            }
+
+            // Plain runs are split at the boundaries
+            for (size_t j = 0; j < run.length; j++, line++) {
+                if (line < headEnd || line >= tailStart) {
+                    add(run.first + j);
+                } else {
+                    skipped++;
+                }
+            }
+        }
+        return kept;
+    }
+
+}
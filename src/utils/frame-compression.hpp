@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace utils {
+
+    /// @brief Longest sequence of frames that is detected as a repeating cycle.
+    inline constexpr size_t MAX_CYCLE_LENGTH = 16;
+
+    /// @brief Amount of lines (after collapsing cycles) kept from both the top and the bottom of a long stack trace.
+    inline constexpr size_t STACK_TRACE_KEEP = 64;
+
+    /// @brief Frame collected by the stack walk, before any symbols are resolved.
+    struct RawFrame {
+        uintptr_t address;
+        uintptr_t framePointer;
+    };
+
+    /// @brief Frames [first, first + length), repeated `repeats` more times right after.
+    struct FrameRun {
+        size_t first;
+        size_t length;
+        size_t repeats;
+
+        bool operator==(const FrameRun &) const = default;
+    };
+
+    /// @brief Frame that is shown in the shortened stack trace.
+    struct KeptFrame {
+        size_t index; // Index of the frame in the walked stack
+        size_t repeatLength; // Length of the cycle ending with this frame, or 0
+        size_t repeatCount; // How many more times the cycle was repeated
+        size_t skippedFrames; // Amount of frames omitted after this one
+
+        bool operator==(const KeptFrame &) const = default;
+    };
+
+    /// @brief Collapse repeating cycles of frames (recursion) into runs.
+    /// At every position, the cycle length covering the most frames wins (the shortest one on ties).
+    /// Consecutive frames that aren't part of a cycle are merged into a single run with no repeats.
+    std::vector<FrameRun> compressFrames(std::span<const RawFrame> frames);
+
+    /// @brief Pick the frames shown for a long stack trace.
+    /// Keeps the first and the last `keep` lines, where a collapsed cycle takes as many lines as it has frames.
+    /// A cycle is only shown whole, even if it crosses the boundary, and the omitted frames
+    /// (including all repeats of a cycle) are counted on the kept frame before them.
+    std::vector<KeptFrame> selectFrames(std::span<const FrameRun> runs, size_t keep = STACK_TRACE_KEEP);
+
+}
@@ -1,7 +1,12 @@
 #include "geode-util.hpp"
 #include <Geode/Geode.hpp>
+#include <atomic>
+#include <chrono>
+#include <mutex>
 
 #include "memory.hpp"
+#include "preload.hpp"
+#include "string-arena.hpp"
 #include "../analyzer/4gb_patch.hpp"
 
 namespace utils::geode {
@@ -78,18 +83,13 @@ namespace utils::geode {
         return version;
     }
 
-    const std::string &getLoaderMetadataMessage() {
-        static std::string message;
-        if (!message.empty()) {
-            return message;
-        }
-
+    std::string createLoaderMetadataMessage() {
         char wd[MAX_PATH];
         GetCurrentDirectoryA(MAX_PATH, wd);
 
         auto problems = ::geode::Loader::get()->getAllProblems();
 
-        message = fmt::format(
+        return fmt::format(
                 "- Working Directory: {}\n{}"
                 "- Loader Version: {} (Geometry Dash v{})\n"
                 "- Loader Commit: {}\n"
@@ -108,6 +108,28 @@ namespace utils::geode {
 #endif
                 problems.size(), problems.empty() ? "" : fmt::format("\n{}", readProblems(problems))
         );
+    }
+
+    LoaderState getLoaderState() {
+        return {
+            getModCount(), getLoadedModCount(), getEnabledModCount(),
+            static_cast<uint32_t>(::geode::Loader::get()->getAllProblems().size())
+        };
+    }
+
+    const std::string &getLoaderMetadataMessage() {
+        static std::string message;
+        if (!message.empty()) {
+            return message;
+        }
+
+        // Use the prepared message, unless the loader state has changed since then
+        auto snapshot = preload::get();
+        if (snapshot && snapshot->loaderState == getLoaderState()) {
+            message = snapshot->loaderMetadata;
+        } else {
+            message = createLoaderMetadataMessage();
+        }
 
         return message;
     }
@@ -146,11 +168,21 @@ namespace utils::geode {
         return ::geode::Mod::get()->getConfigDir();
     }
 
-    const std::vector<ModInfo> &getModList() {
-        static std::vector<ModInfo> mods;
-        if (!mods.empty()) {
-            return mods;
+    ModStatus getModStatus(::geode::Mod *mod) {
+        if (mod->isCurrentlyLoading()) {
+            return ModStatus::IsCurrentlyLoading;
+        } else if (mod->isEnabled()) {
+            return ModStatus::Enabled;
+        } else if (mod->hasLoadProblems()) {
+            return ModStatus::HasProblems;
+        } else if (mod->shouldLoad()) {
+            return ModStatus::ShouldLoad;
         }
+        return ModStatus::Disabled;
+    }
+
+    std::vector<ModInfo> createModList() {
+        std::vector<ModInfo> mods;
 
         auto allMods = ::geode::Loader::get()->getAllMods();
         mods.reserve(allMods.size());
@@ -172,23 +204,12 @@ namespace utils::geode {
                 }
             }
 
-            auto status = ModStatus::Disabled;
-            if (mod->isCurrentlyLoading()) {
-                status = ModStatus::IsCurrentlyLoading;
-            } else if (mod->isEnabled()) {
-                status = ModStatus::Enabled;
-            } else if (mod->hasLoadProblems()) {
-                status = ModStatus::HasProblems;
-            } else if (mod->shouldLoad()) {
-                status = ModStatus::ShouldLoad;
-            }
-
             mods.push_back({
                 metadata.getName(),
                 metadata.getID(),
                 metadata.getVersion().toVString(),
                 developer,
-                status,
+                getModStatus(mod),
                 mod
             });
         }
@@ -196,6 +217,26 @@ namespace utils::geode {
         return mods;
     }
 
+    const std::vector<ModInfo> &getModList() {
+        static std::vector<ModInfo> mods;
+        if (!mods.empty()) {
+            return mods;
+        }
+
+        // Reuse the prepared list if no mods were added since then, only the status has to be refreshed
+        auto snapshot = preload::get();
+        if (snapshot && snapshot->mods.size() == getModCount()) {
+            mods = snapshot->mods;
+            for (auto &mod: mods) {
+                mod.status = getModStatus(mod.mod);
+            }
+        } else {
+            mods = createModList();
+        }
+
+        return mods;
+    }
+
     const std::string &getModListMessage() {
         static std::string message;
         if (!message.empty()) {
@@ -238,73 +279,124 @@ namespace utils::geode {
         return message;
     }
 
-    std::unordered_map<uintptr_t, std::string> readAddressesFrom(const std::filesystem::path &path) {
-        std::unordered_map<uintptr_t, std::string> functions;
-        if (!std::filesystem::exists(path)) {
-            return functions;
+    bool replaceFile(const std::filesystem::path &from, const std::filesystem::path &to) {
+        std::error_code ec;
+        std::filesystem::rename(from, to, ec);
+        if (ec) {
+            ::geode::log::warn("Failed to replace {}: {}", to.string(), ec.message());
+            std::filesystem::remove(from, ec);
+            return false;
         }
+        return true;
+    }
 
-        std::ifstream file(path);
-        if (!file.is_open()) {
-            return functions;
+    bool compileSymbolCache(const std::filesystem::path &path) {
+        auto stamp = SymbolTable::getSourceStamp(path);
+        if (!stamp) return false;
+
+        auto cachePath = SymbolTable::getCachePath(path, *stamp);
+        auto tempPath = cachePath;
+        tempPath += ".tmp";
+        if (!SymbolTable::compileCache(path, tempPath)) {
+            return false;
         }
+        return replaceFile(tempPath, cachePath);
+    }
+
+    SymbolTable readAddressesFrom(const std::filesystem::path &path, bool updateCache) {
+        // Use the precompiled cache if it was built from the same bindings file
+        if (auto stamp = SymbolTable::getSourceStamp(path)) {
+            auto cachePath = SymbolTable::getCachePath(path, *stamp);
+            if (auto cache = SymbolTable::loadCache(cachePath, path)) {
+                return std::move(*cache);
+            }
 
-        std::string line;
-        while (std::getline(file, line)) {
-            auto pos = line.find(" - ");
-            if (pos == std::string::npos) {
-                continue;
+            if (updateCache && compileSymbolCache(path)) {
+                if (auto cache = SymbolTable::loadCache(cachePath, path)) {
+                    return std::move(*cache);
+                }
             }
-            auto address = std::stoull(line.substr(pos + 3), nullptr, 16);
-            functions[address] = line.substr(0, pos);
         }
 
+        MappedFile text;
+        if (!text.open(path)) {
+            return {};
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        auto functions = SymbolTable::parse(std::string(text.view()));
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        ::geode::log::warn("Symbol cache for {} is missing or outdated, parsed {} symbols from text in {} us",
+                           path.filename().string(), functions.size(), elapsed.count());
         return functions;
     }
 
-    const std::unordered_map<uintptr_t, std::string>& getFunctionAddresses() {
-        static std::unordered_map<uintptr_t, std::string> functions;
-        if (!functions.empty()) {
-            return functions;
-        }
+    static std::atomic<std::shared_ptr<const SymbolTable>> s_functions;
+    static std::atomic<std::shared_ptr<const SymbolTable>> s_cocosFunctions;
+    static std::atomic<uint32_t> s_symbolTablesVersion = 0;
 
-        auto codegenPath = getConfigPath() / getBindingsFile();
-        functions = readAddressesFrom(codegenPath);
-        return functions;
+    static std::atomic<std::shared_ptr<const SymbolTable>> &getSymbolTableSlot(bool cocos) {
+        return cocos ? s_cocosFunctions : s_functions;
+    }
+
+    static std::filesystem::path getSymbolTablePath(bool cocos) {
+        return getConfigPath() / (cocos ? getCocosFile() : getBindingsFile());
     }
 
-    const std::unordered_map<uintptr_t, std::string>& getCocosFunctionAddresses() {
-        static std::unordered_map<uintptr_t, std::string> functions;
-        if (!functions.empty()) {
-            return functions;
+    void reloadFunctionAddresses(bool cocos) {
+        // Serialize reloads (preload and downloads), so an older file can never overwrite a newer snapshot.
+        // Readers never take this lock.
+        static std::mutex reloadMutex;
+        std::lock_guard lock(reloadMutex);
+
+        auto path = getSymbolTablePath(cocos);
+        auto table = std::make_shared<const SymbolTable>(readAddressesFrom(path, true));
+        getSymbolTableSlot(cocos).store(std::move(table));
+        s_symbolTablesVersion++;
+
+        // The previous snapshot is usually released by now, so its cache file can be deleted
+        if (auto stamp = SymbolTable::getSourceStamp(path)) {
+            SymbolTable::removeStaleCaches(path, *stamp);
         }
+    }
 
-        auto codegenPath = getConfigPath() / getCocosFile();
-        functions = readAddressesFrom(codegenPath);
-        return functions;
+    std::shared_ptr<const SymbolTable> getFunctionAddresses(bool cocos) {
+        auto &slot = getSymbolTableSlot(cocos);
+        if (auto table = slot.load()) {
+            return table;
+        }
+
+        // Not preloaded yet, so load it right now (without touching the cache files)
+        std::shared_ptr<const SymbolTable> expected;
+        auto table = std::make_shared<const SymbolTable>(readAddressesFrom(getSymbolTablePath(cocos)));
+        if (slot.compare_exchange_strong(expected, table)) {
+            s_symbolTablesVersion++;
+            return table;
+        }
+        return expected; // Someone else published a table in the meantime
     }
 
-    std::pair<uintptr_t, std::string> getFunctionAddress(uintptr_t address, uintptr_t moduleBase, bool useCocos) {
-        auto methodStart = mem::findMethodStart(address);
-        if (methodStart == 0) return {0, ""}; // Outside the 0x1000 offset
+    uint32_t getSymbolTablesVersion() {
+        return s_symbolTablesVersion;
+    }
+
+    std::pair<uintptr_t, std::string_view> getFunctionAddress(
+            uintptr_t address, uintptr_t moduleBase, bool useCocos, uintptr_t methodStart
+    ) {
+        if (methodStart == 0) methodStart = mem::findFunctionStart(address, moduleBase);
+        if (methodStart == 0) return {0, ""}; // No unwind info, and outside the 0x1000 offset
 
         methodStart -= moduleBase; // Get the relative address
 
-        auto functions = useCocos ? getCocosFunctionAddresses() : getFunctionAddresses();
-        auto it = functions.find(methodStart);
-        if (it == functions.end()) {
-            // Check if function was not aligned using "int 3"
-            // (look for functions between `methodStart` and `address`)
-            uintptr_t iterator = address - moduleBase;
-            while (iterator > methodStart) {
-                auto found = functions.find(iterator--);
-                if (found != functions.end()) {
-                    return *found;
-                }
-            }
+        // Take the closest symbol before the address. The heuristic start is not exact (functions are not always
+        // aligned using "int 3"), so the symbol may start anywhere between `methodStart` and `address`.
+        auto functions = getFunctionAddresses(useCocos);
+        auto entry = functions->find(address - moduleBase);
+        if (entry == nullptr || entry->address < methodStart) {
+            return {methodStart, ""};
         }
 
-        return it == functions.end() ? std::make_pair(methodStart, "") : *it;
+        return {entry->address, internSymbol(functions->getName(*entry))};
     }
 
     bool isWine() {
@@ -6,6 +6,9 @@
 #include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include <memory>
+
+#include "symbol-table.hpp"
 
 #define GEODE_DLL __declspec(dllimport)
 
@@ -22,6 +25,22 @@ namespace utils::geode {
     /// @brief Returns a formatted string containing metadata about the loader.
     const std::string& getLoaderMetadataMessage();
 
+    /// @brief Formats the loader metadata message (without caching).
+    std::string createLoaderMetadataMessage();
+
+    /// @brief Counters which change whenever the loader metadata message would change.
+    struct LoaderState {
+        uint32_t modCount = 0;
+        uint32_t loadedModCount = 0;
+        uint32_t enabledModCount = 0;
+        uint32_t problemCount = 0;
+
+        bool operator==(const LoaderState&) const = default;
+    };
+
+    /// @brief Get the current loader state.
+    LoaderState getLoaderState();
+
     /// @brief Returns the version of the game.
     const std::string &getGameVersion();
 
@@ -64,21 +83,52 @@ namespace utils::geode {
         ::geode::Mod* mod;
     };
 
+    /// @brief Get the current status of a mod.
+    ModStatus getModStatus(::geode::Mod* mod);
+
+    /// @brief Build the installed mods list (without caching).
+    std::vector<ModInfo> createModList();
+
     /// @brief Get installed mods list
     const std::vector<ModInfo>& getModList();
 
     /// @brief Get installed/loaded mods list message
     const std::string& getModListMessage();
 
-    const std::unordered_map<uintptr_t, std::string>& getFunctionAddresses();
-    const std::unordered_map<uintptr_t, std::string>& getCocosFunctionAddresses();
+    /// @brief Load a symbol table from a bindings file, using its binary cache if it is up to date.
+    /// @param path Path to the bindings text file
+    /// @param updateCache Whether to recompile the cache if it is missing or outdated
+    SymbolTable readAddressesFrom(const std::filesystem::path& path, bool updateCache = false);
+
+    /// @brief Atomically replace a file with another one.
+    /// @return Whether the file was replaced. On failure, the source file is removed.
+    bool replaceFile(const std::filesystem::path& from, const std::filesystem::path& to);
+
+    /// @brief Compile the binary symbol cache for the current version of a bindings file.
+    /// Every version gets its own cache file (see SymbolTable::getCachePath), the old ones are removed on reload.
+    bool compileSymbolCache(const std::filesystem::path& path);
+
+    /// @brief Load the symbol table from disk and publish it as the new snapshot.
+    /// @param cocos Whether to reload libcocos2d symbols instead of the game symbols
+    void reloadFunctionAddresses(bool cocos);
+
+    /// @brief Get the current (immutable) symbol table snapshot.
+    /// @param cocos Whether to get libcocos2d symbols instead of the game symbols
+    /// @note Never blocks on a reload in progress. The snapshot stays valid as long as the pointer is held.
+    std::shared_ptr<const SymbolTable> getFunctionAddresses(bool cocos = false);
+
+    /// @brief Version of the symbol tables, incremented every time a new snapshot is published.
+    uint32_t getSymbolTablesVersion();
 
     /// @brief Try to find the function address and name from the given address.
-    /// @note If the address is not found, the name will be an empty string
+    /// @note If the address is not found, the name will be empty. Otherwise, it is interned in the analysis arena.
     /// @param address The address to search for
     /// @param moduleBase The base address of the module
     /// @param useCocos Whether to compare against libcocos2d symbols
-    std::pair<uintptr_t, std::string> getFunctionAddress(uintptr_t address, uintptr_t moduleBase, bool useCocos = false);
+    /// @param methodStart Start of the function containing the address, if it's already known
+    std::pair<uintptr_t, std::string_view> getFunctionAddress(
+            uintptr_t address, uintptr_t moduleBase, bool useCocos = false, uintptr_t methodStart = 0
+    );
 
     /// @brief Check whether current system is running Wine.
     bool isWine();
@@ -3,6 +3,7 @@
 #include <fmt/format.h>
 #include <sstream>
 #include "geode-util.hpp"
+#include "preload.hpp"
 
 #include <Windows.h>
 #include <intrin.h>
@@ -217,23 +218,30 @@ namespace hwinfo {
         return os.str();
     }
 
+    SystemInfo getSystemInfo() {
+        return {getCPUName(), getCPUCores(), getCPUThreads(), getGPUName(), getOSName()};
+    }
+
     std::string getMessage() {
         static std::string message;
         if (!message.empty()) {
             return message;
         }
 
+        auto snapshot = utils::preload::get();
+        auto info = snapshot ? snapshot->systemInfo : getSystemInfo();
+
         message = fmt::format(
             "- CPU: {} ({} cores, {} threads)\n"
             "- GPU: {}\n"
             "- RAM: {} MB total, {} MB used, {} MB free\n"
             "- SWAP: {} MB total, {} MB used, {} MB free\n"
             "- OS: {}\n",
-            getCPUName(), getCPUCores(), getCPUThreads(),
-            getGPUName(),
+            info.cpuName, info.cpuCores, info.cpuThreads,
+            info.gpuName,
             ram::total(), ram::used(), ram::free(),
             swap::total(), swap::used(), swap::free(),
-            getOSName()
+            info.osName
         );
 
         return message;
@@ -54,6 +54,19 @@ namespace hwinfo {
     /// @return Name of the operating system (e.g. "Windows 11 x64 (v.10.0.22000.318)").
     std::string getOSName();
 
+    /// @brief Hardware information that doesn't change while the game is running.
+    struct SystemInfo {
+        std::string cpuName;
+        uint32_t cpuCores = 0;
+        uint32_t cpuThreads = 0;
+        std::string gpuName;
+        std::string osName;
+    };
+
+    /// @brief Query the hardware information that doesn't change while the game is running.
+    /// @note This is slow (DXGI enumeration, WMI and registry queries), prefer the preloaded snapshot.
+    SystemInfo getSystemInfo();
+
     /// @brief Get the message containing all hardware information.
     std::string getMessage();
 
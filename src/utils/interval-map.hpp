@@ -0,0 +1,100 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+    /// @brief Sorted array of non-overlapping [begin, end) address intervals with a value attached to each.
+    /// Lookups are a binary search, which is much cheaper than a linear scan when there are hundreds of intervals.
+    template <typename T>
+    class IntervalMap {
+    public:
+        struct Interval {
+            uintptr_t begin; // First address of the interval
+            uintptr_t end; // One past the last address of the interval
+            T value;
+
+            [[nodiscard]] bool contains(uintptr_t address) const {
+                return address >= begin && address < end;
+            }
+        };
+
+        /// @brief Insert an interval. An existing interval with the same start address is replaced.
+        /// @note Intervals are expected to not overlap.
+        void insert(uintptr_t begin, uintptr_t end, T value) {
+            auto it = lowerBound(begin);
+            if (it != m_intervals.end() && it->begin == begin) {
+                it->end = end;
+                it->value = std::move(value);
+                return;
+            }
+            m_intervals.insert(it, Interval{begin, end, std::move(value)});
+        }
+
+        /// @brief Remove the interval which starts at the given address.
+        /// @return Whether the interval was found.
+        bool erase(uintptr_t begin) {
+            auto it = lowerBound(begin);
+            if (it == m_intervals.end() || it->begin != begin) return false;
+            m_intervals.erase(it);
+            return true;
+        }
+
+        /// @brief Remove all intervals that don't satisfy the predicate.
+        template <typename Predicate>
+        size_t retain(Predicate predicate) {
+            auto it = std::remove_if(m_intervals.begin(), m_intervals.end(), [&](const Interval &interval) {
+                return !predicate(interval);
+            });
+            auto removed = static_cast<size_t>(m_intervals.end() - it);
+            m_intervals.erase(it, m_intervals.end());
+            return removed;
+        }
+
+        /// @brief Find the interval containing the address.
+        /// @return The interval, or nullptr if the address is not inside any interval.
+        [[nodiscard]] const Interval *find(uintptr_t address) const {
+            auto it = std::upper_bound(
+                    m_intervals.begin(), m_intervals.end(), address,
+                    [](uintptr_t value, const Interval &interval) { return value < interval.begin; }
+            );
+            if (it == m_intervals.begin()) return nullptr;
+            --it;
+            return it->contains(address) ? &*it : nullptr;
+        }
+
+        /// @brief Find the interval which starts exactly at the given address.
+        [[nodiscard]] const Interval *findExact(uintptr_t begin) const {
+            auto it = std::lower_bound(
+                    m_intervals.begin(), m_intervals.end(), begin,
+                    [](const Interval &interval, uintptr_t value) { return interval.begin < value; }
+            );
+            if (it == m_intervals.end() || it->begin != begin) return nullptr;
+            return &*it;
+        }
+
+        void clear() { m_intervals.clear(); }
+        void reserve(size_t count) { m_intervals.reserve(count); }
+
+        [[nodiscard]] size_t size() const { return m_intervals.size(); }
+        [[nodiscard]] bool empty() const { return m_intervals.empty(); }
+
+        [[nodiscard]] auto begin() const { return m_intervals.begin(); }
+        [[nodiscard]] auto end() const { return m_intervals.end(); }
+
+    private:
+        typename std::vector<Interval>::iterator lowerBound(uintptr_t begin) {
+            return std::lower_bound(
+                    m_intervals.begin(), m_intervals.end(), begin,
+                    [](const Interval &interval, uintptr_t value) { return interval.begin < value; }
+            );
+        }
+
+        std::vector<Interval> m_intervals;
+    };
+
+}
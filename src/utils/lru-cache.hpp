@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace utils {
+
+    /// @brief Bounded map which evicts the least recently used entry when it is full.
+    /// @note Not thread-safe.
+    template <typename Key, typename Value>
+    class LruCache {
+    public:
+        explicit LruCache(size_t capacity) : m_capacity(capacity == 0 ? 1 : capacity) {}
+
+        /// @brief Get an entry and mark it as recently used.
+        /// @return Pointer to the value, or nullptr if the key is not cached.
+        /// @note The pointer is valid until the entry is evicted or erased.
+        Value *get(const Key &key) {
+            auto it = m_index.find(key);
+            if (it == m_index.end()) return nullptr;
+            m_items.splice(m_items.begin(), m_items, it->second);
+            return &it->second->second;
+        }
+
+        /// @brief Insert or replace an entry, evicting the least recently used one if the cache is full.
+        Value &put(const Key &key, Value value) {
+            if (auto existing = get(key)) {
+                *existing = std::move(value);
+                return *existing;
+            }
+
+            if (m_items.size() >= m_capacity) {
+                m_index.erase(m_items.back().first);
+                m_items.pop_back();
+            }
+
+            m_items.emplace_front(key, std::move(value));
+            m_index.emplace(key, m_items.begin());
+            return m_items.front().second;
+        }
+
+        /// @brief Remove all entries for which the predicate returns true.
+        /// @return Amount of removed entries.
+        template <typename Predicate>
+        size_t eraseIf(Predicate predicate) {
+            size_t removed = 0;
+            for (auto it = m_items.begin(); it != m_items.end();) {
+                if (predicate(it->first, it->second)) {
+                    m_index.erase(it->first);
+                    it = m_items.erase(it);
+                    removed++;
+                } else {
+                    ++it;
+                }
+            }
+            return removed;
+        }
+
+        void clear() {
+            m_items.clear();
+            m_index.clear();
+        }
+
+        [[nodiscard]] size_t size() const { return m_items.size(); }
+        [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    private:
+        using List = std::list<std::pair<Key, Value>>;
+
+        List m_items; // Most recently used first
+        std::unordered_map<Key, typename List::iterator> m_index;
+        size_t m_capacity;
+    };
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace utils {
+
+    /// @brief Read-only memory mapping of a whole file.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+        MappedFile(MappedFile &&other) noexcept;
+        MappedFile &operator=(MappedFile &&other) noexcept;
+
+        /// @brief Map the file into memory.
+        /// @return Whether the file was mapped successfully. Empty files can not be mapped.
+        bool open(const std::filesystem::path &path);
+
+        /// @brief Unmap the file.
+        void close();
+
+        [[nodiscard]] bool isOpen() const { return m_data != nullptr; }
+        [[nodiscard]] const uint8_t *data() const { return m_data; }
+        [[nodiscard]] size_t size() const { return m_size; }
+
+        [[nodiscard]] std::string_view view() const {
+            return {reinterpret_cast<const char *>(m_data), m_size};
+        }
+
+    private:
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+}
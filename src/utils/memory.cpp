@@ -0,0 +1,40 @@
+#include "memory.hpp"
+
+#include <atomic>
+
+namespace utils::mem {
+
+    static std::atomic<std::shared_ptr<const RegionTable>> s_regions;
+
+    void captureRegions() {
+        auto table = std::make_shared<RegionTable>();
+
+        SYSTEM_INFO systemInfo;
+        GetSystemInfo(&systemInfo);
+        auto address = reinterpret_cast<uintptr_t>(systemInfo.lpMinimumApplicationAddress);
+        auto maxAddress = reinterpret_cast<uintptr_t>(systemInfo.lpMaximumApplicationAddress);
+
+        MEMORY_BASIC_INFORMATION mbi;
+        while (address < maxAddress && VirtualQuery((void*) address, &mbi, sizeof(mbi)) != 0) {
+            auto base = reinterpret_cast<uintptr_t>(mbi.BaseAddress);
+            if (mbi.State == MEM_COMMIT) {
+                table->add(base, mbi.RegionSize, getRegionAccess(mbi));
+            }
+
+            auto next = base + mbi.RegionSize;
+            if (next <= address) break; // Wrapped around
+            address = next;
+        }
+
+        s_regions.store(std::move(table));
+    }
+
+    void releaseRegions() {
+        s_regions.store(nullptr);
+    }
+
+    std::shared_ptr<const RegionTable> getRegionSnapshot() {
+        return s_regions.load();
+    }
+
+}
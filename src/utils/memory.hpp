@@ -5,52 +5,151 @@
 #include <psapi.h>
 #include <fmt/format.h>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <tuple>
+
+#include "pe-image.hpp"
+#include "prologue-scan.hpp"
+#include "region-table.hpp"
+#include "string-scan.hpp"
 
 namespace utils::mem {
 
+    /// @brief Check if the memory region can be read without faulting.
+    inline bool isReadableRegion(const MEMORY_BASIC_INFORMATION &mbi) {
+        return mbi.State == MEM_COMMIT && !(mbi.Protect & (PAGE_NOACCESS | PAGE_GUARD));
+    }
+
+    /// @brief Convert the protection of a memory region into access rights.
+    inline RegionAccess getRegionAccess(const MEMORY_BASIC_INFORMATION &mbi) {
+        RegionAccess access;
+        access.readable = isReadableRegion(mbi);
+        access.writable = mbi.Protect & (PAGE_READWRITE | PAGE_WRITECOPY | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY);
+        access.executable = mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY);
+        return access;
+    }
+
+    /// @brief Take a snapshot of all committed memory regions of the process.
+    /// Until `releaseRegions` is called, the pointer checks below use the snapshot instead of calling VirtualQuery.
+    void captureRegions();
+
+    /// @brief Stop using the region snapshot.
+    void releaseRegions();
+
+    /// @brief Get the current region snapshot.
+    /// @return The snapshot, or nullptr if there is none.
+    std::shared_ptr<const RegionTable> getRegionSnapshot();
+
     /// @brief Check if the address is accessible.
+    /// @note The answer can be outdated by the time the memory is read, so use `readMemory` for the read itself.
     inline bool isAccessible(uintptr_t address) {
+        if (auto regions = getRegionSnapshot()) {
+            return regions->isReadable(address);
+        }
+
         MEMORY_BASIC_INFORMATION mbi;
         if (VirtualQuery((void*) address, &mbi, sizeof(mbi)) == 0) {
             return false;
         }
-        return mbi.State == MEM_COMMIT;
+        return isReadableRegion(mbi);
     }
 
-    /// @brief Check if the address is a valid string pointer.
-    inline bool isStringPtr(uintptr_t address) {
-        if (!isAccessible(address)) return false;
+    /// @brief Get the amount of bytes that can be read starting at the address.
+    /// Reading continues into the next pages only while they are known to be readable.
+    /// @param address The address to start from.
+    /// @param limit The maximum amount of bytes needed.
+    /// @return The amount of readable bytes, at most `limit`.
+    /// @note Like `isAccessible`, this is only a hint: reads of the range have to go through `readMemory`
+    /// (or another SEH guard) when the memory can change in the meantime.
+    inline size_t getReadableSize(uintptr_t address, size_t limit) {
+        if (auto regions = getRegionSnapshot()) {
+            return regions->getReadableSize(address, limit);
+        }
 
-        // Check if the string is null-terminated
-        __try {
-            if ((const char*)address == nullptr || strlen((const char*)address) >= 1024) {
-                return false;
+        MEMORY_BASIC_INFORMATION mbi;
+        if (VirtualQuery((void*) address, &mbi, sizeof(mbi)) == 0 || !isReadableRegion(mbi)) {
+            return 0;
+        }
+
+        auto end = (uintptr_t) mbi.BaseAddress + mbi.RegionSize;
+        while (end - address < limit) {
+            if (VirtualQuery((void*) end, &mbi, sizeof(mbi)) == 0 || !isReadableRegion(mbi)) {
+                break;
             }
+            end += mbi.RegionSize;
+        }
+        return std::min<size_t>(limit, end - address);
+    }
+
+    /// @brief Copy memory from the address, without faulting if it was released after it was checked.
+    /// The checks above can be stale (the region snapshot lives as long as the crash window), so reads that
+    /// can run on the worker pool must not fault: a fault there would re-enter the crash handler.
+    /// @return Whether the whole range was copied.
+    inline bool readMemory(uintptr_t address, void* buffer, size_t size) {
+        __try {
+            std::memcpy(buffer, (const void*) address, size);
+            return true;
         } __except(EXCEPTION_EXECUTE_HANDLER) {
             return false;
         }
+    }
 
-        // Check if the string is printable
-        char *ptr = (char *) address;
-        while (*ptr) {
-            if (*ptr < 32 && *ptr != '\n' && *ptr != '\r') {
-                return false;
-            }
-            ptr++;
+    /// @brief Get the length of a printable UTF-8 string at the address.
+    /// @return The length in bytes, or std::nullopt if the address doesn't point to a string.
+    inline std::optional<size_t> getStringLength(uintptr_t address) {
+        auto size = getReadableSize(address, MAX_STRING_LENGTH);
+        if (size == 0) return std::nullopt;
+
+        // The range was readable when checked, but another thread might release it in the meantime
+        __try {
+            return scanCString((const uint8_t*) address, size);
+        } __except(EXCEPTION_EXECUTE_HANDLER) {
+            return std::nullopt;
         }
-        return true;
+    }
+
+    /// @brief Get the length of a printable UTF-16 string (`wchar_t*`) at the address.
+    /// @return The length in characters, or std::nullopt if the address doesn't point to a wide string.
+    inline std::optional<size_t> getWideStringLength(uintptr_t address) {
+        if (address % sizeof(char16_t) != 0) return std::nullopt;
+
+        auto size = getReadableSize(address, MAX_STRING_LENGTH * sizeof(char16_t));
+        if (size < sizeof(char16_t)) return std::nullopt;
+
+        __try {
+            return scanWideString((const char16_t*) address, size / sizeof(char16_t));
+        } __except(EXCEPTION_EXECUTE_HANDLER) {
+            return std::nullopt;
+        }
+    }
+
+    /// @brief Check if the address is a valid string pointer.
+    inline bool isStringPtr(uintptr_t address) {
+        return getStringLength(address).has_value();
+    }
+
+    /// @brief Check if the address is a valid wide string pointer.
+    inline bool isWideStringPtr(uintptr_t address) {
+        return getWideStringLength(address).has_value();
     }
 
     /// @brief Check if the address is a valid function pointer.
     inline bool isFunctionPtr(uintptr_t address) {
-        if (!isAccessible(address)) return false;
+        if (auto regions = getRegionSnapshot()) {
+            auto access = regions->find(address);
+            return access && access->readable && access->executable;
+        }
 
         MEMORY_BASIC_INFORMATION mbi;
         if (VirtualQuery((void*) address, &mbi, sizeof(mbi)) == 0) {
             return false;
         }
 
-        return mbi.Protect & (PAGE_EXECUTE | PAGE_EXECUTE_READ | PAGE_EXECUTE_READWRITE | PAGE_EXECUTE_WRITECOPY);
+        auto access = getRegionAccess(mbi);
+        return access.readable && access.executable;
     }
 
     /// @brief Get the module handle from an address.
@@ -72,30 +171,65 @@ namespace utils::mem {
         return buffer;
     }
 
+    /// @brief Scan for the last prologue in the range, treating a fault (the range was released) as no match.
+    inline uintptr_t findLastPrologueGuarded(uintptr_t low, uintptr_t high) {
+        __try {
+            return (uintptr_t) findLastPrologue((const uint8_t*) low, (const uint8_t*) high, PROLOGUE_BYTES);
+        } __except(EXCEPTION_EXECUTE_HANDLER) {
+            return 0;
+        }
+    }
+
     /// @brief Get the address of a function by backtracking until we get a 0xCC55 (int 3, push ebp) sequence.
     /// @param address The address to start from.
     /// @param maxOffset The maximum offset to search for (for safety).
     /// @return The address of the "push ebp" instruction if found, otherwise 0.
     inline uintptr_t findMethodStart(uintptr_t address, uintptr_t maxOffset = 0x1000) {
-        uintptr_t offset = 0;
-        while (offset < maxOffset) {
-            uint16_t instruction = *(uint16_t*) (address - offset);
-#ifndef _WIN64
-            // int 3, (push ebp | jmp) sequence
-            // jmp is used because some functions may be hooked
-            if (instruction == 0x55CC || instruction == 0xE9CC) {
-                return address - offset + 1;
+        // Clamp the search range to readable memory, so the scan never touches an unmapped page
+        uintptr_t target = address > maxOffset ? address - maxOffset + 1 : 0;
+        uintptr_t low, high;
+        if (auto regions = getRegionSnapshot()) {
+            std::tie(low, high) = regions->readableRange(address);
+            if (high == 0) return 0;
+            high = std::min<uintptr_t>(address + 2, high);
+        } else {
+            MEMORY_BASIC_INFORMATION mbi;
+            if (VirtualQuery((void*) address, &mbi, sizeof(mbi)) == 0 || !isReadableRegion(mbi)) {
+                return 0;
             }
-#else
-            // int 3, (push rbx | jmp) sequence
-            // or int 3, (mov [rsp+...], rbx | jmp) sequence
-            if (instruction == 0x40CC || instruction == 0x48CC || instruction == 0xE9CC) {
-                return address - offset + 1;
+
+            // Regions are split on protection changes (e.g. by hooks), so extend backwards through adjacent ones
+            low = (uintptr_t) mbi.BaseAddress;
+            high = std::min<uintptr_t>(address + 2, low + mbi.RegionSize);
+            while (low > target) {
+                MEMORY_BASIC_INFORMATION previous;
+                if (VirtualQuery((void*) (low - 1), &previous, sizeof(previous)) == 0 || !isReadableRegion(previous)) {
+                    break;
+                }
+                low = (uintptr_t) previous.BaseAddress;
             }
-#endif
-            offset++;
         }
-        return 0;
+        low = std::max(low, target);
+
+        return findLastPrologueGuarded(low, high);
+    }
+
+    /// @brief Get the start of the function containing an address.
+    /// On x64 the exact start is taken from the exception directory of the module,
+    /// with `findMethodStart` as a fallback for functions without unwind info (and for x86).
+    /// @param address The address inside the function.
+    /// @param moduleBase The base address of the module containing the address.
+    /// @return The address of the function start if found, otherwise 0.
+    inline uintptr_t findFunctionStart(uintptr_t address, uintptr_t moduleBase) {
+        if (moduleBase != 0 && address > moduleBase) {
+            if (auto image = pe::Image::fromMemory((const uint8_t*) moduleBase)) {
+                if (auto function = image->findFunction(static_cast<uint32_t>(address - moduleBase))) {
+                    return moduleBase + function->begin;
+                }
+            }
+        }
+
+        return findMethodStart(address);
     }
 
     /// @brief Write memory to an address.
@@ -0,0 +1,286 @@
+#include "pe-image.hpp"
+
+#include <algorithm>
+
+namespace utils::pe {
+
+    static constexpr uint16_t DOS_SIGNATURE = 0x5A4D; // "MZ"
+    static constexpr uint32_t NT_SIGNATURE = 0x00004550; // "PE\0\0"
+    static constexpr uint16_t OPTIONAL_HEADER32_MAGIC = 0x10B;
+    static constexpr uint16_t OPTIONAL_HEADER64_MAGIC = 0x20B;
+    static constexpr uint16_t MACHINE_AMD64 = 0x8664;
+    static constexpr uint8_t UNW_FLAG_CHAININFO = 0x4;
+    static constexpr uint32_t RUNTIME_FUNCTION_INDIRECT = 0x1;
+
+    // Size of the headers page, used to parse a loaded module before its size is known
+    static constexpr size_t HEADERS_SIZE = 0x1000;
+
+    // Limit for following chained unwind info, in case the image is corrupted
+    static constexpr int MAX_CHAIN_DEPTH = 32;
+
+    std::optional<Image> Image::fromMemory(const uint8_t *base, size_t size) {
+        if (!base) return std::nullopt;
+
+        Image image;
+        image.m_data = base;
+        image.m_size = size != 0 ? size : HEADERS_SIZE;
+        image.m_mapped = true;
+        if (!image.parse()) return std::nullopt;
+
+        if (size == 0) {
+            image.m_size = image.m_sizeOfImage;
+        }
+        return image;
+    }
+
+    std::optional<Image> Image::fromFile(std::span<const uint8_t> data) {
+        Image image;
+        image.m_data = data.data();
+        image.m_size = data.size();
+        image.m_mapped = false;
+        if (!image.parse()) return std::nullopt;
+        return image;
+    }
+
+    template <typename T>
+    static std::optional<T> readRaw(const uint8_t *data, size_t size, size_t offset) {
+        if (offset > size || size - offset < sizeof(T)) return std::nullopt;
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+
+    bool Image::parse() {
+        auto dosSignature = readRaw<uint16_t>(m_data, m_size, 0);
+        if (!dosSignature || *dosSignature != DOS_SIGNATURE) return false;
+
+        auto ntOffset = readRaw<uint32_t>(m_data, m_size, 0x3C);
+        if (!ntOffset) return false;
+
+        auto ntSignature = readRaw<uint32_t>(m_data, m_size, *ntOffset);
+        if (!ntSignature || *ntSignature != NT_SIGNATURE) return false;
+
+        // IMAGE_FILE_HEADER
+        size_t fileHeader = *ntOffset + 4;
+        auto machine = readRaw<uint16_t>(m_data, m_size, fileHeader);
+        auto sectionCount = readRaw<uint16_t>(m_data, m_size, fileHeader + 2);
+        auto optionalHeaderSize = readRaw<uint16_t>(m_data, m_size, fileHeader + 16);
+        if (!machine || !sectionCount || !optionalHeaderSize) return false;
+
+        // IMAGE_OPTIONAL_HEADER32 / IMAGE_OPTIONAL_HEADER64
+        size_t optionalHeader = fileHeader + 20;
+        auto magic = readRaw<uint16_t>(m_data, m_size, optionalHeader);
+        if (!magic) return false;
+
+        size_t directoriesOffset;
+        std::optional<uint32_t> directoryCount;
+        if (*magic == OPTIONAL_HEADER64_MAGIC) {
+            m_is64 = true;
+            auto imageBase = readRaw<uint64_t>(m_data, m_size, optionalHeader + 24);
+            if (!imageBase) return false;
+            m_imageBase = *imageBase;
+            directoryCount = readRaw<uint32_t>(m_data, m_size, optionalHeader + 108);
+            directoriesOffset = optionalHeader + 112;
+        } else if (*magic == OPTIONAL_HEADER32_MAGIC) {
+            m_is64 = false;
+            auto imageBase = readRaw<uint32_t>(m_data, m_size, optionalHeader + 28);
+            if (!imageBase) return false;
+            m_imageBase = *imageBase;
+            directoryCount = readRaw<uint32_t>(m_data, m_size, optionalHeader + 92);
+            directoriesOffset = optionalHeader + 96;
+        } else {
+            return false;
+        }
+
+        auto sizeOfImage = readRaw<uint32_t>(m_data, m_size, optionalHeader + 56);
+        if (!sizeOfImage || !directoryCount) return false;
+        m_sizeOfImage = *sizeOfImage;
+
+        m_directories.clear();
+        for (uint32_t i = 0; i < std::min<uint32_t>(*directoryCount, 16); i++) {
+            auto directory = readRaw<DataDirectory>(m_data, m_size, directoriesOffset + i * sizeof(DataDirectory));
+            if (!directory) break;
+            m_directories.push_back(*directory);
+        }
+
+        // IMAGE_SECTION_HEADER
+        m_sections.clear();
+        size_t sectionsOffset = optionalHeader + *optionalHeaderSize;
+        for (uint16_t i = 0; i < *sectionCount; i++) {
+            size_t offset = sectionsOffset + i * 40;
+            auto virtualSize = readRaw<uint32_t>(m_data, m_size, offset + 8);
+            auto virtualAddress = readRaw<uint32_t>(m_data, m_size, offset + 12);
+            auto sizeOfRawData = readRaw<uint32_t>(m_data, m_size, offset + 16);
+            auto pointerToRawData = readRaw<uint32_t>(m_data, m_size, offset + 20);
+            auto characteristics = readRaw<uint32_t>(m_data, m_size, offset + 36);
+            if (!virtualSize || !virtualAddress || !sizeOfRawData || !pointerToRawData || !characteristics) {
+                return false;
+            }
+
+            Section section{};
+            std::memcpy(section.name, m_data + offset, sizeof(section.name));
+            section.virtualSize = *virtualSize;
+            section.virtualAddress = *virtualAddress;
+            section.sizeOfRawData = *sizeOfRawData;
+            section.pointerToRawData = *pointerToRawData;
+            section.characteristics = *characteristics;
+            m_sections.push_back(section);
+        }
+
+        // The exception directory only has the RUNTIME_FUNCTION layout on x64
+        m_runtimeFunctionsRva = 0;
+        m_runtimeFunctionCount = 0;
+        if (*machine == MACHINE_AMD64) {
+            if (auto exceptions = directory(Directory::Exception)) {
+                m_runtimeFunctionsRva = exceptions->virtualAddress;
+                m_runtimeFunctionCount = exceptions->size / sizeof(RuntimeFunction);
+            }
+        }
+
+        return true;
+    }
+
+    std::optional<DataDirectory> Image::directory(Directory index) const {
+        auto i = static_cast<size_t>(index);
+        if (i >= m_directories.size()) return std::nullopt;
+        auto directory = m_directories[i];
+        if (directory.virtualAddress == 0 || directory.size == 0) return std::nullopt;
+        return directory;
+    }
+
+    const Section *Image::sectionFromRva(uint32_t rva) const {
+        for (const auto &section: m_sections) {
+            if (section.containsRva(rva)) return &section;
+        }
+        return nullptr;
+    }
+
+    std::span<const uint8_t> Image::rvaToSpan(uint32_t rva) const {
+        if (m_mapped) {
+            if (rva >= m_size) return {};
+            return {m_data + rva, m_size - rva};
+        }
+
+        // On disk, sections are stored at their raw offsets
+        if (auto section = sectionFromRva(rva)) {
+            size_t offset = rva - section->virtualAddress;
+            if (offset >= section->sizeOfRawData) return {};
+            size_t available = section->sizeOfRawData - offset;
+            offset += section->pointerToRawData;
+            if (offset >= m_size) return {};
+            return {m_data + offset, std::min(available, m_size - offset)};
+        }
+
+        // Headers are stored the same way in both layouts
+        size_t headersEnd = m_sections.empty() ? HEADERS_SIZE : m_sections.front().virtualAddress;
+        headersEnd = std::min(headersEnd, m_size);
+        if (rva >= headersEnd) return {};
+        return {m_data + rva, headersEnd - rva};
+    }
+
+    const uint8_t *Image::rvaToPointer(uint32_t rva, size_t size) const {
+        auto span = rvaToSpan(rva);
+        if (span.empty() || span.size() < size) return nullptr;
+        return span.data();
+    }
+
+    const char *Image::readString(uint32_t rva, size_t maxLength) const {
+        auto span = rvaToSpan(rva);
+        auto length = std::min(span.size(), maxLength);
+        if (length == 0 || !std::memchr(span.data(), 0, length)) return nullptr;
+        return reinterpret_cast<const char *>(span.data());
+    }
+
+    RuntimeFunction Image::runtimeFunction(size_t index) const {
+        auto entry = read<RuntimeFunction>(m_runtimeFunctionsRva + static_cast<uint32_t>(index * sizeof(RuntimeFunction)));
+        return entry.value_or(RuntimeFunction{});
+    }
+
+    std::optional<RuntimeFunction> Image::findRuntimeFunction(uint32_t rva) const {
+        // The table is sorted by the start address, so take the last entry starting before the RVA
+        size_t low = 0, high = m_runtimeFunctionCount;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (runtimeFunction(middle).beginAddress <= rva) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        if (low == 0) return std::nullopt;
+
+        auto entry = runtimeFunction(low - 1);
+        if (rva >= entry.endAddress) return std::nullopt;
+        return entry;
+    }
+
+    std::optional<FunctionRange> Image::findFunction(uint32_t rva) const {
+        auto entry = findRuntimeFunction(rva);
+        if (!entry) return std::nullopt;
+
+        for (int depth = 0; depth < MAX_CHAIN_DEPTH; depth++) {
+            // The entry can reference another RUNTIME_FUNCTION instead of the unwind info
+            if (entry->unwindInfoAddress & RUNTIME_FUNCTION_INDIRECT) {
+                entry = read<RuntimeFunction>(entry->unwindInfoAddress & ~RUNTIME_FUNCTION_INDIRECT);
+                if (!entry) return std::nullopt;
+                continue;
+            }
+
+            // UNWIND_INFO: version (3 bits) + flags (5 bits), prolog size, code count, frame register
+            auto header = read<uint8_t>(entry->unwindInfoAddress);
+            auto codeCount = read<uint8_t>(entry->unwindInfoAddress + 2);
+            if (!header || !codeCount) return std::nullopt;
+
+            uint8_t flags = *header >> 3;
+            if (!(flags & UNW_FLAG_CHAININFO)) {
+                return FunctionRange{entry->beginAddress, entry->endAddress};
+            }
+
+            // Chained info is stored after the unwind codes (aligned to an even count)
+            uint32_t chained = entry->unwindInfoAddress + 4 + ((*codeCount + 1) & ~1) * 2;
+            entry = read<RuntimeFunction>(chained);
+            if (!entry) return std::nullopt;
+        }
+
+        return std::nullopt;
+    }
+
+    std::vector<Export> Image::functionExports() const {
+        std::vector<Export> result;
+
+        auto exports = directory(Directory::Export);
+        if (!exports) return result;
+
+        // IMAGE_EXPORT_DIRECTORY
+        auto functionCount = read<uint32_t>(exports->virtualAddress + 20);
+        auto nameCount = read<uint32_t>(exports->virtualAddress + 24);
+        auto functions = read<uint32_t>(exports->virtualAddress + 28);
+        auto names = read<uint32_t>(exports->virtualAddress + 32);
+        auto ordinals = read<uint32_t>(exports->virtualAddress + 36);
+        if (!functionCount || !nameCount || !functions || !names || !ordinals) return result;
+
+        result.reserve(*nameCount);
+        for (uint32_t i = 0; i < *nameCount; i++) {
+            auto nameRva = read<uint32_t>(*names + i * 4);
+            auto ordinal = read<uint16_t>(*ordinals + i * 2);
+            if (!nameRva || !ordinal || *ordinal >= *functionCount) continue;
+
+            auto rva = read<uint32_t>(*functions + *ordinal * 4);
+            if (!rva || *rva == 0) continue;
+
+            // Forwarded exports point to a string inside the export directory
+            if (*rva >= exports->virtualAddress && *rva - exports->virtualAddress < exports->size) continue;
+
+            auto section = sectionFromRva(*rva);
+            if (!section || !section->isExecutable()) continue;
+
+            auto name = readString(*nameRva);
+            if (!name || *name == 0) continue;
+
+            result.push_back({*rva, name});
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <vector>
+
+/// @brief Minimal read-only PE parser, which works both on loaded modules and on files read from disk.
+/// It doesn't depend on the Windows headers, so it can be used on any platform.
+namespace utils::pe {
+
+    /// @brief Indices of the data directories in the optional header.
+    enum class Directory : uint32_t {
+        Export = 0,
+        Import = 1,
+        Resource = 2,
+        Exception = 3,
+    };
+
+    struct DataDirectory {
+        uint32_t virtualAddress;
+        uint32_t size;
+    };
+
+    struct Section {
+        char name[8];
+        uint32_t virtualSize;
+        uint32_t virtualAddress;
+        uint32_t sizeOfRawData;
+        uint32_t pointerToRawData;
+        uint32_t characteristics;
+
+        static constexpr uint32_t EXECUTABLE = 0x20000000; // IMAGE_SCN_MEM_EXECUTE
+
+        [[nodiscard]] bool isExecutable() const { return (characteristics & EXECUTABLE) != 0; }
+
+        [[nodiscard]] bool containsRva(uint32_t rva) const {
+            auto size = virtualSize != 0 ? virtualSize : sizeOfRawData;
+            return rva >= virtualAddress && rva - virtualAddress < size;
+        }
+    };
+
+    /// @brief Entry of the exception directory (x64 RUNTIME_FUNCTION).
+    struct RuntimeFunction {
+        uint32_t beginAddress;
+        uint32_t endAddress;
+        uint32_t unwindInfoAddress;
+    };
+
+    /// @brief Function boundaries, relative to the image base.
+    struct FunctionRange {
+        uint32_t begin;
+        uint32_t end; // End of the primary entry (exclusive)
+    };
+
+    /// @brief Named function exported by the image.
+    struct Export {
+        uint32_t rva;
+        const char *name; // Points into the image data
+    };
+
+    class Image {
+    public:
+        /// @brief Parse a module loaded into memory (sections are placed at their virtual addresses).
+        /// @param base Base address of the module
+        /// @param size Size of the readable image, or 0 to take it from the headers
+        static std::optional<Image> fromMemory(const uint8_t *base, size_t size = 0);
+
+        /// @brief Parse a PE file as it is stored on disk (sections are placed at their raw offsets).
+        /// @note The image only references the data, so it has to outlive the image.
+        static std::optional<Image> fromFile(std::span<const uint8_t> data);
+
+        /// @brief Whether the image is PE32+ (64-bit).
+        [[nodiscard]] bool is64() const { return m_is64; }
+
+        [[nodiscard]] uint64_t imageBase() const { return m_imageBase; }
+        [[nodiscard]] uint32_t sizeOfImage() const { return m_sizeOfImage; }
+        [[nodiscard]] const std::vector<Section> &sections() const { return m_sections; }
+
+        /// @brief Get a data directory, if the image has it.
+        [[nodiscard]] std::optional<DataDirectory> directory(Directory index) const;
+
+        /// @brief Get the section containing the RVA.
+        [[nodiscard]] const Section *sectionFromRva(uint32_t rva) const;
+
+        /// @brief Translate an RVA into a pointer to `size` readable bytes.
+        /// @return The pointer, or nullptr if the range is outside the image.
+        [[nodiscard]] const uint8_t *rvaToPointer(uint32_t rva, size_t size = 1) const;
+
+        /// @brief Read a value at an RVA.
+        template <typename T>
+        [[nodiscard]] std::optional<T> read(uint32_t rva) const {
+            auto ptr = rvaToPointer(rva, sizeof(T));
+            if (!ptr) return std::nullopt;
+            T value;
+            std::memcpy(&value, ptr, sizeof(T));
+            return value;
+        }
+
+        /// @brief Read a null-terminated string at an RVA.
+        /// @return Pointer to the string, or nullptr if it is not terminated inside the image.
+        [[nodiscard]] const char *readString(uint32_t rva, size_t maxLength = 1024) const;
+
+        /// @brief Amount of entries in the exception directory.
+        [[nodiscard]] size_t runtimeFunctionCount() const { return m_runtimeFunctionCount; }
+
+        /// @brief Get an entry of the exception directory.
+        [[nodiscard]] RuntimeFunction runtimeFunction(size_t index) const;
+
+        /// @brief Find the exception directory entry containing the RVA.
+        [[nodiscard]] std::optional<RuntimeFunction> findRuntimeFunction(uint32_t rva) const;
+
+        /// @brief Find the function containing the RVA using the exception directory (x64 only).
+        /// Chained unwind info is followed back to the primary entry, so the start is always the real function start.
+        [[nodiscard]] std::optional<FunctionRange> findFunction(uint32_t rva) const;
+
+        /// @brief Get the named exports which point to code.
+        /// Forwarded exports and exports outside of executable sections (data) are skipped.
+        [[nodiscard]] std::vector<Export> functionExports() const;
+
+    private:
+        bool parse();
+
+        /// @brief Get the bytes readable starting at an RVA (up to the end of its section).
+        [[nodiscard]] std::span<const uint8_t> rvaToSpan(uint32_t rva) const;
+
+        const uint8_t *m_data = nullptr;
+        size_t m_size = 0;
+        bool m_mapped = false;
+
+        bool m_is64 = false;
+        uint64_t m_imageBase = 0;
+        uint32_t m_sizeOfImage = 0;
+        std::vector<DataDirectory> m_directories;
+        std::vector<Section> m_sections;
+
+        uint32_t m_runtimeFunctionsRva = 0;
+        size_t m_runtimeFunctionCount = 0;
+    };
+
+}
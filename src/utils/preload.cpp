@@ -0,0 +1,51 @@
+#include "preload.hpp"
+
+#include <Geode/Geode.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <Windows.h>
+
+#include "thread-pool.hpp"
+
+namespace utils::preload {
+
+    static std::atomic<std::shared_ptr<const Snapshot>> s_snapshot;
+
+    /// @brief Finish the snapshot with the slow parts, then compile the symbol caches.
+    /// @param snapshot The snapshot with the Geode sections already filled in (on the main thread)
+    static void run(std::shared_ptr<Snapshot> snapshot) {
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+        SetThreadDescription(GetCurrentThread(), L"BetterCrashlogs Preload");
+
+        auto start = std::chrono::steady_clock::now();
+
+        snapshot->systemInfo = hwinfo::getSystemInfo();
+        s_snapshot.store(std::move(snapshot));
+
+        // This also compiles the binary caches if they are missing or outdated
+        geode::reloadFunctionAddresses(false);
+        geode::reloadFunctionAddresses(true);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        ::geode::log::info("Crash handler data prepared in {} ms", elapsed.count());
+    }
+
+    void start() {
+        ThreadPool::get().start();
+
+        // The loader is not thread-safe, so the sections reading the mod list are built here (on the main thread)
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->loaderState = geode::getLoaderState();
+        snapshot->loaderMetadata = geode::createLoaderMetadataMessage();
+        snapshot->mods = geode::createModList();
+
+        std::thread(run, std::move(snapshot)).detach();
+    }
+
+    std::shared_ptr<const Snapshot> get() {
+        return s_snapshot.load();
+    }
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "geode-util.hpp"
+#include "hwinfo.hpp"
+
+/// @brief Data that is prepared in the background, so the crash handler doesn't have to compute it
+/// while the game is frozen.
+namespace utils::preload {
+
+    struct Snapshot {
+        geode::LoaderState loaderState; // Loader state the metadata was built for
+        std::string loaderMetadata;
+        std::vector<geode::ModInfo> mods;
+        hwinfo::SystemInfo systemInfo;
+    };
+
+    /// @brief Prepare the snapshot and load the symbol tables.
+    /// The sections that query the Geode loader are built right away, so this must be called on the main thread.
+    /// System information and the symbol tables are prepared on a low-priority background thread.
+    /// Also starts the worker pool used by the analyzer.
+    void start();
+
+    /// @brief Get the prepared snapshot.
+    /// @return The snapshot, or nullptr if it is not ready yet.
+    /// @note Once published, the snapshot is never replaced, so references into it stay valid.
+    std::shared_ptr<const Snapshot> get();
+
+}
@@ -0,0 +1,171 @@
+#include "prologue-scan.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PROLOGUE_SCAN_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+#define PROLOGUE_SCAN_TARGET(name) __attribute__((target(name)))
+#else
+#define PROLOGUE_SCAN_TARGET(name)
+#endif
+
+namespace utils::mem {
+
+    static bool isPrologue(uint8_t byte, std::span<const uint8_t> prologues) {
+        return std::find(prologues.begin(), prologues.end(), byte) != prologues.end();
+    }
+
+    const uint8_t *findLastPrologueScalar(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues) {
+        if (high - low < 2) return nullptr;
+
+        for (auto ptr = high - 2;; --ptr) {
+            if (ptr[0] == 0xCC && isPrologue(ptr[1], prologues)) {
+                return ptr + 1;
+            }
+            if (ptr == low) break;
+        }
+        return nullptr;
+    }
+
+#ifdef PROLOGUE_SCAN_X86
+
+    static constexpr size_t MAX_PROLOGUES = 4;
+
+    static const uint8_t *findLastPrologueSSE2(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues) {
+        if (high - low < 2) return nullptr;
+
+        const auto padding = _mm_set1_epi8(static_cast<char>(0xCC));
+        __m128i patterns[MAX_PROLOGUES];
+        for (size_t i = 0; i < prologues.size(); i++) {
+            patterns[i] = _mm_set1_epi8(static_cast<char>(prologues[i]));
+        }
+
+        // Candidates are the `0xCC` positions, so the last one is `high - 2`
+        auto end = high - 1;
+        while (end - low >= 16) {
+            auto block = end - 16;
+            auto first = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+            auto second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + 1));
+
+            auto matches = _mm_setzero_si128();
+            for (size_t i = 0; i < prologues.size(); i++) {
+                matches = _mm_or_si128(matches, _mm_cmpeq_epi8(second, patterns[i]));
+            }
+            matches = _mm_and_si128(matches, _mm_cmpeq_epi8(first, padding));
+
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(matches));
+            if (mask != 0) {
+                return block + (31 - std::countl_zero(mask)) + 1;
+            }
+            end = block;
+        }
+
+        return findLastPrologueScalar(low, end + 1, prologues);
+    }
+
+    PROLOGUE_SCAN_TARGET("avx2")
+    static const uint8_t *findLastPrologueAVX2(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues) {
+        if (high - low < 2) return nullptr;
+
+        const auto padding = _mm256_set1_epi8(static_cast<char>(0xCC));
+        __m256i patterns[MAX_PROLOGUES];
+        for (size_t i = 0; i < prologues.size(); i++) {
+            patterns[i] = _mm256_set1_epi8(static_cast<char>(prologues[i]));
+        }
+
+        auto end = high - 1;
+        while (end - low >= 32) {
+            auto block = end - 32;
+            auto first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+            auto second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 1));
+
+            auto matches = _mm256_setzero_si256();
+            for (size_t i = 0; i < prologues.size(); i++) {
+                matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(second, patterns[i]));
+            }
+            matches = _mm256_and_si256(matches, _mm256_cmpeq_epi8(first, padding));
+
+            auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+            if (mask != 0) {
+                return block + (31 - std::countl_zero(mask)) + 1;
+            }
+            end = block;
+        }
+
+        return findLastPrologueSSE2(low, end + 1, prologues);
+    }
+
+    PROLOGUE_SCAN_TARGET("xsave")
+    static bool detectAVX2() {
+        int info[4];
+#ifdef _MSC_VER
+        __cpuid(info, 0);
+        if (info[0] < 7) return false;
+        __cpuid(info, 1);
+#else
+        if (__get_cpuid_max(0, nullptr) < 7) return false;
+        __cpuid(1, info[0], info[1], info[2], info[3]);
+#endif
+        // The OS has to save the YMM registers on context switches
+        constexpr int OSXSAVE = 1 << 27, AVX = 1 << 28;
+        if ((info[2] & (OSXSAVE | AVX)) != (OSXSAVE | AVX)) return false;
+        if ((_xgetbv(0) & 6) != 6) return false;
+
+#ifdef _MSC_VER
+        __cpuidex(info, 7, 0);
+#else
+        __cpuid_count(7, 0, info[0], info[1], info[2], info[3]);
+#endif
+        return (info[1] & (1 << 5)) != 0;
+    }
+
+    ScanKernel getBestScanKernel() {
+        // SSE2 is part of x64, and required by the game on x86 anyway
+        static const auto kernel = detectAVX2() ? ScanKernel::AVX2 : ScanKernel::SSE2;
+        return kernel;
+    }
+
+    const uint8_t *findLastPrologue(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues,
+                                    ScanKernel kernel) {
+        if (prologues.empty() || prologues.size() > MAX_PROLOGUES) {
+            return findLastPrologueScalar(low, high, prologues);
+        }
+
+        switch (std::min(kernel, getBestScanKernel())) {
+            case ScanKernel::AVX2:
+                return findLastPrologueAVX2(low, high, prologues);
+            case ScanKernel::SSE2:
+                return findLastPrologueSSE2(low, high, prologues);
+            default:
+                return findLastPrologueScalar(low, high, prologues);
+        }
+    }
+
+#else
+
+    ScanKernel getBestScanKernel() {
+        return ScanKernel::Scalar;
+    }
+
+    const uint8_t *findLastPrologue(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues,
+                                    ScanKernel kernel) {
+        return findLastPrologueScalar(low, high, prologues);
+    }
+
+#endif
+
+    const uint8_t *findLastPrologue(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues) {
+        return findLastPrologue(low, high, prologues, getBestScanKernel());
+    }
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+namespace utils::mem {
+
+    /// @brief Bytes that can follow an `int 3` padding byte at the start of a function.
+#ifndef _WIN64
+    // push ebp | jmp (some functions may be hooked)
+    inline constexpr uint8_t PROLOGUE_BYTES[] = {0x55, 0xE9};
+#else
+    // push rbx | mov [rsp+...], rbx | jmp (some functions may be hooked)
+    inline constexpr uint8_t PROLOGUE_BYTES[] = {0x40, 0x48, 0xE9};
+#endif
+
+    /// @brief Instruction sets `findLastPrologue` can use, from the slowest to the fastest.
+    enum class ScanKernel {
+        Scalar,
+        SSE2,
+        AVX2,
+    };
+
+    /// @brief Get the fastest kernel the CPU supports.
+    ScanKernel getBestScanKernel();
+
+    /// @brief Find the last `0xCC, <prologue byte>` pair inside the buffer.
+    /// Uses AVX2 or SSE2 when available, and never reads outside of [low, high).
+    /// @param low Start of the readable range
+    /// @param high End of the readable range (exclusive)
+    /// @param prologues Bytes that may follow `0xCC` (at most 4)
+    /// @return Pointer to the prologue byte of the match closest to `high`, or nullptr if there is none.
+    const uint8_t *findLastPrologue(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues);
+
+    /// @brief Version of `findLastPrologue` using a specific kernel, so every kernel can be tested on one CPU.
+    /// Kernels the CPU doesn't support fall back to the fastest one it does.
+    const uint8_t *findLastPrologue(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues,
+                                    ScanKernel kernel);
+
+    /// @brief Scalar version of `findLastPrologue`.
+    const uint8_t *findLastPrologueScalar(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues);
+
+}
@@ -0,0 +1,73 @@
+#include "region-table.hpp"
+
+#include <algorithm>
+
+namespace utils::mem {
+
+    void RegionTable::add(uintptr_t base, size_t size, RegionAccess access) {
+        if (size == 0) return;
+
+        // Merge with the previous region, if it's adjacent and has the same rights
+        if (!m_regions.empty() && base == m_lastEnd && access == m_lastAccess) {
+            m_lastEnd = base + size;
+            m_regions.insert(m_lastBegin, m_lastEnd, access);
+            return;
+        }
+
+        m_regions.insert(base, base + size, access);
+        m_lastBegin = base;
+        m_lastEnd = base + size;
+        m_lastAccess = access;
+    }
+
+    const RegionAccess *RegionTable::find(uintptr_t address) const {
+        auto region = m_regions.find(address);
+        return region ? &region->value : nullptr;
+    }
+
+    bool RegionTable::isReadable(uintptr_t address) const {
+        auto access = find(address);
+        return access && access->readable;
+    }
+
+    bool RegionTable::isReadable(uintptr_t address, size_t size) const {
+        if (size == 0) return isReadable(address);
+        if (address + size < address) return false; // Overflow
+
+        auto range = readableRange(address);
+        return range.second != 0 && address + size <= range.second;
+    }
+
+    bool RegionTable::isExecutable(uintptr_t address) const {
+        auto access = find(address);
+        return access && access->executable;
+    }
+
+    std::pair<uintptr_t, uintptr_t> RegionTable::readableRange(uintptr_t address) const {
+        auto region = m_regions.find(address);
+        if (!region || !region->value.readable) return {0, 0};
+
+        // Regions are stored contiguously, so neighbours can be reached directly
+        auto first = &*m_regions.begin();
+        auto last = first + m_regions.size();
+
+        auto begin = region;
+        while (begin != first && (begin - 1)->end == begin->begin && (begin - 1)->value.readable) {
+            --begin;
+        }
+
+        auto end = region;
+        while (end + 1 != last && (end + 1)->begin == end->end && (end + 1)->value.readable) {
+            ++end;
+        }
+
+        return {begin->begin, end->end};
+    }
+
+    size_t RegionTable::getReadableSize(uintptr_t address, size_t limit) const {
+        auto end = readableRange(address).second;
+        if (end == 0) return 0;
+        return std::min<size_t>(limit, end - address);
+    }
+
+}
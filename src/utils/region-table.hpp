@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "interval-map.hpp"
+
+namespace utils::mem {
+
+    /// @brief Access rights of a committed memory region.
+    struct RegionAccess {
+        bool readable = false;
+        bool writable = false;
+        bool executable = false;
+
+        bool operator==(const RegionAccess &) const = default;
+    };
+
+    /// @brief Sorted table of the committed memory regions of a process.
+    /// Built once from the OS (see `captureRegions`), so that pointer validation doesn't need a syscall per query.
+    /// Addresses outside of any region are treated as not committed.
+    /// @note A snapshot only says what was readable when it was taken. Memory can be released or protected
+    /// afterwards, so the reads themselves still have to be guarded (see `readMemory` in memory.hpp).
+    class RegionTable {
+    public:
+        /// @brief Add a committed region.
+        /// Adjacent regions with the same access rights are merged.
+        /// @note Regions have to be added in ascending order and must not overlap.
+        void add(uintptr_t base, size_t size, RegionAccess access);
+
+        /// @brief Get the access rights of the region containing the address.
+        /// @return The access rights, or nullptr if the address is not committed.
+        [[nodiscard]] const RegionAccess *find(uintptr_t address) const;
+
+        /// @brief Check if the address can be read.
+        [[nodiscard]] bool isReadable(uintptr_t address) const;
+
+        /// @brief Check if the whole range [address, address + size) can be read.
+        [[nodiscard]] bool isReadable(uintptr_t address, size_t size) const;
+
+        /// @brief Check if the address points to executable memory.
+        [[nodiscard]] bool isExecutable(uintptr_t address) const;
+
+        /// @brief Get the largest contiguous readable range containing the address.
+        /// @return [begin, end) of the range, or {0, 0} if the address is not readable.
+        [[nodiscard]] std::pair<uintptr_t, uintptr_t> readableRange(uintptr_t address) const;
+
+        /// @brief Get the amount of bytes that can be read starting at the address, across adjacent readable regions.
+        /// @return The amount of readable bytes, at most `limit`.
+        [[nodiscard]] size_t getReadableSize(uintptr_t address, size_t limit) const;
+
+        [[nodiscard]] size_t size() const { return m_regions.size(); }
+        [[nodiscard]] bool empty() const { return m_regions.empty(); }
+
+    private:
+        IntervalMap<RegionAccess> m_regions;
+        uintptr_t m_lastBegin = 0;
+        uintptr_t m_lastEnd = 0;
+        RegionAccess m_lastAccess;
+    };
+
+}
@@ -0,0 +1,75 @@
+#include "string-arena.hpp"
+
+#include <cstring>
+
+namespace utils {
+
+    std::string_view StringArena::intern(std::string_view str) {
+        if (str.empty()) return {};
+
+        std::lock_guard lock(m_mutex);
+
+        auto it = m_strings.find(str);
+        if (it != m_strings.end()) {
+            return *it;
+        }
+
+        auto data = allocate(str.size());
+        std::memcpy(data, str.data(), str.size());
+
+        std::string_view interned(data, str.size());
+        m_strings.insert(interned);
+        return interned;
+    }
+
+    void StringArena::clear() {
+        std::lock_guard lock(m_mutex);
+        m_strings.clear();
+        m_blocks.clear();
+        m_cursor = nullptr;
+        m_remaining = 0;
+        m_allocated = 0;
+    }
+
+    size_t StringArena::count() const {
+        std::lock_guard lock(m_mutex);
+        return m_strings.size();
+    }
+
+    size_t StringArena::allocated() const {
+        std::lock_guard lock(m_mutex);
+        return m_allocated;
+    }
+
+    char *StringArena::allocate(size_t size) {
+        // Large strings get their own block, so they don't waste the rest of the current one
+        if (size > BLOCK_SIZE / 4) {
+            m_blocks.emplace_back(new char[size]);
+            m_allocated += size;
+            return m_blocks.back().get();
+        }
+
+        if (size > m_remaining) {
+            m_blocks.emplace_back(new char[BLOCK_SIZE]);
+            m_cursor = m_blocks.back().get();
+            m_remaining = BLOCK_SIZE;
+            m_allocated += BLOCK_SIZE;
+        }
+
+        auto result = m_cursor;
+        m_cursor += size;
+        m_remaining -= size;
+        return result;
+    }
+
+    StringArena &getStringArena() {
+        static StringArena arena;
+        return arena;
+    }
+
+    StringArena &getAnalysisArena() {
+        static StringArena arena;
+        return arena;
+    }
+
+}
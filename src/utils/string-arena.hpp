@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+namespace utils {
+
+    /// @brief Deduplicating string storage backed by a bump allocator.
+    /// Interned strings are only freed by `clear`, so the returned views stay valid until then.
+    class StringArena {
+    public:
+        /// @brief Get the interned copy of a string.
+        /// @note Thread-safe.
+        std::string_view intern(std::string_view str);
+
+        /// @brief Free all strings.
+        /// @warning Invalidates every view returned by `intern`.
+        void clear();
+
+        /// @brief Amount of unique strings stored.
+        [[nodiscard]] size_t count() const;
+
+        /// @brief Amount of bytes allocated for the string data.
+        [[nodiscard]] size_t allocated() const;
+
+    private:
+        static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+        char *allocate(size_t size);
+
+        mutable std::mutex m_mutex;
+        std::unordered_set<std::string_view> m_strings;
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        char *m_cursor = nullptr;
+        size_t m_remaining = 0;
+        size_t m_allocated = 0;
+    };
+
+    /// @brief Get the global string arena, for names that exist once per process (modules, source files).
+    StringArena &getStringArena();
+
+    /// @brief Get the arena of the current analysis, for function and class names.
+    /// Every lookup can add new ones, so it is cleared with the analysis (see `Analyzer::cleanup`).
+    StringArena &getAnalysisArena();
+
+    /// @brief Intern a string in the global arena.
+    inline std::string_view intern(std::string_view str) {
+        return getStringArena().intern(str);
+    }
+
+    /// @brief Intern a function or class name in the analysis arena.
+    inline std::string_view internSymbol(std::string_view str) {
+        return getAnalysisArena().intern(str);
+    }
+
+}
@@ -0,0 +1,179 @@
+#include "string-scan.hpp"
+
+#include <bit>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define STRING_SCAN_X86
+#include <emmintrin.h>
+#endif
+
+namespace utils::mem {
+
+    /// @brief Check if an ASCII character can appear in a printable string.
+    static bool isPrintableAscii(uint8_t byte) {
+        return (byte >= 0x20 && byte != 0x7F) || byte == '\t' || byte == '\n' || byte == '\r';
+    }
+
+    /// @brief Validate the multibyte UTF-8 sequence starting at `data`.
+    /// @return Length of the sequence, or 0 if it is malformed, truncated or encodes a C1 control character.
+    static size_t getUtf8SequenceLength(const uint8_t *data, size_t size) {
+        uint8_t lead = data[0];
+        size_t length;
+        uint8_t low = 0x80, high = 0xBF; // Allowed range of the second byte
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+            if (lead == 0xC2) low = 0xA0; // U+0080..U+009F are control characters
+        } else if (lead >= 0xE0 && lead <= 0xEF) {
+            length = 3;
+            if (lead == 0xE0) low = 0xA0; // Overlong
+            if (lead == 0xED) high = 0x9F; // Surrogates
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+            if (lead == 0xF0) low = 0x90; // Overlong
+            if (lead == 0xF4) high = 0x8F; // Above U+10FFFF
+        } else {
+            return 0;
+        }
+
+        if (size < length) return 0;
+        if (data[1] < low || data[1] > high) return 0;
+        for (size_t i = 2; i < length; i++) {
+            if ((data[i] & 0xC0) != 0x80) return 0;
+        }
+        return length;
+    }
+
+    /// @brief Validate the string starting at `offset`, one character at a time.
+    static std::optional<size_t> scanCStringFrom(const uint8_t *data, size_t size, size_t offset) {
+        while (offset < size) {
+            uint8_t byte = data[offset];
+            if (byte == 0) return offset;
+
+            if (byte < 0x80) {
+                if (!isPrintableAscii(byte)) return std::nullopt;
+                offset++;
+                continue;
+            }
+
+            auto length = getUtf8SequenceLength(data + offset, size - offset);
+            if (length == 0) return std::nullopt;
+            offset += length;
+        }
+        return std::nullopt; // No terminator
+    }
+
+    std::optional<size_t> scanCStringScalar(const uint8_t *data, size_t size) {
+        return scanCStringFrom(data, size, 0);
+    }
+
+#ifdef STRING_SCAN_X86
+
+    std::optional<size_t> scanCString(const uint8_t *data, size_t size) {
+        const auto space = _mm_set1_epi8(0x20);
+        const auto del = _mm_set1_epi8(0x7F);
+        const auto tab = _mm_set1_epi8('\t');
+        const auto newline = _mm_set1_epi8('\n');
+        const auto carriage = _mm_set1_epi8('\r');
+
+        size_t offset = 0;
+        while (size - offset >= 16) {
+            auto block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + offset));
+
+            // Signed comparison, so this catches the terminator, control characters and all non-ASCII bytes
+            auto special = _mm_cmplt_epi8(block, space);
+            auto whitespace = _mm_or_si128(
+                    _mm_cmpeq_epi8(block, tab),
+                    _mm_or_si128(_mm_cmpeq_epi8(block, newline), _mm_cmpeq_epi8(block, carriage))
+            );
+            special = _mm_or_si128(_mm_andnot_si128(whitespace, special), _mm_cmpeq_epi8(block, del));
+
+            auto mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+            if (mask == 0) {
+                offset += 16;
+                continue;
+            }
+
+            offset += std::countr_zero(mask);
+            uint8_t byte = data[offset];
+            if (byte == 0) return offset;
+            if (byte < 0x80) return std::nullopt; // Control character
+
+            // Continue with the vector loop right after the multibyte character
+            auto length = getUtf8SequenceLength(data + offset, size - offset);
+            if (length == 0) return std::nullopt;
+            offset += length;
+        }
+
+        return scanCStringFrom(data, size, offset);
+    }
+
+#else
+
+    std::optional<size_t> scanCString(const uint8_t *data, size_t size) {
+        return scanCStringScalar(data, size);
+    }
+
+#endif
+
+    std::optional<size_t> scanWideString(const char16_t *data, size_t size) {
+        size_t ascii = 0;
+        for (size_t i = 0; i < size; i++) {
+            char16_t unit = data[i];
+            if (unit == 0) {
+                // Random data often looks like CJK text, while most strings in the game are ASCII
+                if (i < 2 || ascii * 2 < i) return std::nullopt;
+                return i;
+            }
+
+            if (unit < 0x80) {
+                if (!isPrintableAscii(static_cast<uint8_t>(unit))) return std::nullopt;
+                ascii++;
+            } else if (unit < 0xA0) {
+                return std::nullopt; // C1 control characters
+            } else if (unit >= 0xD800 && unit <= 0xDBFF) {
+                if (i + 1 >= size || data[i + 1] < 0xDC00 || data[i + 1] > 0xDFFF) return std::nullopt;
+                i++;
+            } else if (unit >= 0xDC00 && unit <= 0xDFFF) {
+                return std::nullopt; // Unpaired low surrogate
+            } else if (unit >= 0xFFFE) {
+                return std::nullopt; // Noncharacters
+            }
+        }
+        return std::nullopt;
+    }
+
+    std::string wideToUtf8(const char16_t *data, size_t length) {
+        std::string result;
+        result.reserve(length);
+
+        for (size_t i = 0; i < length; i++) {
+            uint32_t codepoint = data[i];
+            if (codepoint >= 0xD800 && codepoint <= 0xDBFF && i + 1 < length
+                && data[i + 1] >= 0xDC00 && data[i + 1] <= 0xDFFF) {
+                codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (data[i + 1] - 0xDC00);
+                i++;
+            } else if (codepoint >= 0xD800 && codepoint <= 0xDFFF) {
+                codepoint = 0xFFFD;
+            }
+
+            if (codepoint < 0x80) {
+                result += static_cast<char>(codepoint);
+            } else if (codepoint < 0x800) {
+                result += static_cast<char>(0xC0 | (codepoint >> 6));
+                result += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else if (codepoint < 0x10000) {
+                result += static_cast<char>(0xE0 | (codepoint >> 12));
+                result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (codepoint & 0x3F));
+            } else {
+                result += static_cast<char>(0xF0 | (codepoint >> 18));
+                result += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                result += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                result += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        return result;
+    }
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+namespace utils::mem {
+
+    /// @brief Longest string (including the terminator) that is considered when classifying values.
+    inline constexpr size_t MAX_STRING_LENGTH = 1024;
+
+    /// @brief Check if the buffer starts with a null-terminated, printable UTF-8 string.
+    /// Finds the terminator and validates the characters in a single pass (using SSE2 when available).
+    /// Control characters other than tabs and line breaks are rejected, as well as malformed UTF-8.
+    /// @param data Start of the string
+    /// @param size Amount of bytes that can be read from `data`
+    /// @return Length of the string in bytes (without the terminator), or std::nullopt if there is no valid string
+    ///         terminated inside the buffer.
+    std::optional<size_t> scanCString(const uint8_t *data, size_t size);
+
+    /// @brief Scalar version of `scanCString`.
+    std::optional<size_t> scanCStringScalar(const uint8_t *data, size_t size);
+
+    /// @brief Check if the buffer starts with a null-terminated, printable UTF-16 string (e.g. a `wchar_t*`).
+    /// Since almost any data is valid UTF-16, strings shorter than 2 characters or with mostly non-ASCII
+    /// characters are rejected as well.
+    /// @param data Start of the string
+    /// @param size Amount of code units (not bytes) that can be read from `data`
+    /// @return Length of the string in code units (without the terminator), or std::nullopt.
+    std::optional<size_t> scanWideString(const char16_t *data, size_t size);
+
+    /// @brief Convert a UTF-16 string into UTF-8.
+    /// Unpaired surrogates are replaced with U+FFFD.
+    std::string wideToUtf8(const char16_t *data, size_t length);
+
+}
@@ -0,0 +1,232 @@
+#include "symbol-table.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace utils {
+
+    static constexpr char CACHE_MAGIC[4] = {'B', 'C', 'S', 'Y'};
+
+    void SymbolTable::add(uintptr_t address, std::string_view name) {
+        m_entries.push_back({address, static_cast<uint32_t>(m_names.size()), static_cast<uint32_t>(name.size())});
+        m_names.append(name);
+        m_entryCount = m_entries.size();
+    }
+
+    void SymbolTable::finalize() {
+        std::stable_sort(m_entries.begin(), m_entries.end(), [](const Entry &a, const Entry &b) {
+            return a.address < b.address;
+        });
+
+        // Keep only the last entry for every address (same behavior as overwriting a map key)
+        auto last = std::unique(m_entries.rbegin(), m_entries.rend(), [](const Entry &a, const Entry &b) {
+            return a.address == b.address;
+        });
+        m_entries.erase(m_entries.begin(), last.base());
+        m_entries.shrink_to_fit();
+        m_entryCount = m_entries.size();
+    }
+
+    const SymbolTable::Entry *SymbolTable::entries() const {
+        if (m_cache.isOpen()) {
+            return reinterpret_cast<const Entry *>(m_cache.data() + sizeof(CacheHeader));
+        }
+        return m_entries.data();
+    }
+
+    std::string_view SymbolTable::names() const {
+        if (m_cache.isOpen()) {
+            auto offset = sizeof(CacheHeader) + m_entryCount * sizeof(Entry);
+            return m_cache.view().substr(offset);
+        }
+        return m_names;
+    }
+
+    const SymbolTable::Entry *SymbolTable::find(uintptr_t address) const {
+        auto begin = entries();
+        auto end = begin + m_entryCount;
+        auto it = std::upper_bound(begin, end, address, [](uintptr_t value, const Entry &entry) {
+            return value < entry.address;
+        });
+        if (it == begin) return nullptr;
+        return it - 1;
+    }
+
+    std::string_view SymbolTable::getName(const Entry &entry) const {
+        auto blob = names();
+        if (entry.nameOffset > blob.size()) return {};
+        return blob.substr(entry.nameOffset, entry.nameLength);
+    }
+
+    SymbolTable SymbolTable::parse(std::string text) {
+        SymbolTable table;
+        table.m_names = std::move(text); // names are referenced directly inside the text
+
+        const char *begin = table.m_names.data();
+        auto end = begin + table.m_names.size();
+
+        // Every line holds at most one symbol, so count them to reserve the table up front
+        size_t lineCount = 1;
+        for (auto it = begin; (it = static_cast<const char *>(std::memchr(it, '\n', end - it))) != nullptr; it++) {
+            lineCount++;
+        }
+        table.m_entries.reserve(lineCount);
+
+        for (auto it = begin; it < end;) {
+            auto lineEnd = static_cast<const char *>(std::memchr(it, '\n', end - it));
+            if (lineEnd == nullptr) lineEnd = end;
+            std::string_view line(it, lineEnd - it);
+            it = lineEnd + 1;
+
+            auto pos = line.find(" - ");
+            if (pos == std::string_view::npos) {
+                continue;
+            }
+
+            auto addressStr = line.substr(pos + 3);
+            while (!addressStr.empty() && addressStr.front() == ' ') addressStr.remove_prefix(1);
+            if (addressStr.size() >= 2 && addressStr[0] == '0' && (addressStr[1] == 'x' || addressStr[1] == 'X')) {
+                addressStr.remove_prefix(2);
+            }
+
+            uint64_t address;
+            auto result = std::from_chars(addressStr.data(), addressStr.data() + addressStr.size(), address, 16);
+            if (result.ec != std::errc()) {
+                continue;
+            }
+
+            table.m_entries.push_back({address, static_cast<uint32_t>(line.data() - begin), static_cast<uint32_t>(pos)});
+        }
+
+        table.finalize();
+        return table;
+    }
+
+    uint64_t SymbolTable::hash(std::string_view text) {
+        uint64_t result = 0xcbf29ce484222325ull;
+        for (auto c: text) {
+            result ^= static_cast<uint8_t>(c);
+            result *= 0x100000001b3ull;
+        }
+        return result;
+    }
+
+    std::optional<SymbolTable::SourceStamp> SymbolTable::getSourceStamp(const std::filesystem::path &path) {
+        std::error_code error;
+        auto size = std::filesystem::file_size(path, error);
+        if (error) return std::nullopt;
+        auto modified = std::filesystem::last_write_time(path, error);
+        if (error) return std::nullopt;
+        return SourceStamp{size, static_cast<int64_t>(modified.time_since_epoch().count())};
+    }
+
+    bool SymbolTable::saveCache(const std::filesystem::path &path, std::string_view source, SourceStamp stamp) const {
+        // Pack the names, since a parsed table still references the whole bindings text
+        std::vector<Entry> packedEntries(entries(), entries() + m_entryCount);
+        std::string packedNames;
+        for (auto &entry: packedEntries) {
+            auto name = getName(entry);
+            entry.nameOffset = static_cast<uint32_t>(packedNames.size());
+            entry.nameLength = static_cast<uint32_t>(name.size());
+            packedNames.append(name);
+        }
+
+        CacheHeader header{};
+        std::memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+        header.version = CACHE_VERSION;
+        header.sourceHash = hash(source);
+        header.sourceSize = source.size();
+        header.sourceModified = stamp.modified;
+        header.entryCount = static_cast<uint32_t>(packedEntries.size());
+        header.namesSize = static_cast<uint32_t>(packedNames.size());
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) return false;
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(packedEntries.data()),
+                   static_cast<std::streamsize>(packedEntries.size() * sizeof(Entry)));
+        file.write(packedNames.data(), static_cast<std::streamsize>(packedNames.size()));
+        return file.good();
+    }
+
+    std::optional<SymbolTable> SymbolTable::loadCache(const std::filesystem::path &path,
+                                                      const std::filesystem::path &sourcePath) {
+        SymbolTable table;
+        if (!table.m_cache.open(path)) return std::nullopt;
+        if (table.m_cache.size() < sizeof(CacheHeader)) return std::nullopt;
+
+        CacheHeader header{};
+        std::memcpy(&header, table.m_cache.data(), sizeof(header));
+        if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(header.magic)) != 0) return std::nullopt;
+        if (header.version != CACHE_VERSION) return std::nullopt;
+
+        auto expectedSize = sizeof(CacheHeader) + uint64_t(header.entryCount) * sizeof(Entry) + header.namesSize;
+        if (table.m_cache.size() != expectedSize) return std::nullopt;
+
+        // Bindings file was updated after the cache was compiled
+        auto stamp = getSourceStamp(sourcePath);
+        if (!stamp || stamp->size != header.sourceSize) return std::nullopt;
+        if (stamp->modified != header.sourceModified) {
+            MappedFile source;
+            if (!source.open(sourcePath) || source.size() != header.sourceSize) return std::nullopt;
+            if (hash(source.view()) != header.sourceHash) return std::nullopt;
+        }
+
+        table.m_entryCount = header.entryCount;
+        return table;
+    }
+
+    bool SymbolTable::compileCache(const std::filesystem::path &textPath, const std::filesystem::path &cachePath) {
+        // Stamp first: if the file is rewritten while it is read, the stamp won't match and the cache gets rehashed
+        auto stamp = getSourceStamp(textPath);
+        MappedFile text;
+        if (!stamp || !text.open(textPath)) return false;
+
+        auto table = parse(std::string(text.view()));
+        return table.saveCache(cachePath, text.view(), *stamp);
+    }
+
+    std::filesystem::path SymbolTable::getCachePath(const std::filesystem::path &sourcePath, SourceStamp stamp) {
+        char version[40];
+        std::snprintf(version, sizeof(version), ".%llx-%llx.bin", static_cast<unsigned long long>(stamp.size),
+                      static_cast<unsigned long long>(stamp.modified));
+        auto path = sourcePath;
+        path.replace_extension();
+        path += version;
+        return path;
+    }
+
+    /// @brief Check if the file name is "<stem>.bin" or "<stem>.<stamp>.bin" for the given bindings file stem.
+    static bool isCacheFileName(std::string_view name, std::string_view stem) {
+        constexpr std::string_view extension = ".bin";
+        if (name.size() < stem.size() + extension.size() || !name.starts_with(stem) || !name.ends_with(extension)) {
+            return false;
+        }
+
+        auto version = name.substr(stem.size(), name.size() - stem.size() - extension.size());
+        if (version.empty()) return true; // Unversioned cache of older releases
+        if (version.front() != '.') return false;
+        return std::all_of(version.begin() + 1, version.end(), [](char c) {
+            return c == '-' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+        });
+    }
+
+    size_t SymbolTable::removeStaleCaches(const std::filesystem::path &sourcePath, SourceStamp stamp) {
+        auto current = getCachePath(sourcePath, stamp).filename();
+        auto stem = sourcePath.stem().string();
+
+        size_t removed = 0;
+        std::error_code error;
+        for (const auto &entry: std::filesystem::directory_iterator(sourcePath.parent_path(), error)) {
+            auto name = entry.path().filename();
+            if (name == current || !isCacheFileName(name.string(), stem)) continue;
+            if (std::filesystem::remove(entry.path(), error)) removed++;
+        }
+        return removed;
+    }
+
+}
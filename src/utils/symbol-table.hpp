@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mapped-file.hpp"
+
+namespace utils {
+
+    /// @brief Sorted, contiguous index of function symbols (module-relative address -> name).
+    /// All names are stored in a single string blob, entries only keep an offset into it.
+    /// The table can either own its data, or use a memory-mapped binary cache file directly.
+    class SymbolTable {
+    public:
+        struct Entry {
+            uint64_t address; // Address, relative to the module base
+            uint32_t nameOffset; // Offset of the name in the string blob
+            uint32_t nameLength; // Length of the name
+        };
+
+        /// @brief Size and modification time of a bindings file, which tell if it changed without reading it.
+        struct SourceStamp {
+            uint64_t size;
+            int64_t modified; // Last write time, in file clock ticks
+
+            bool operator==(const SourceStamp &) const = default;
+        };
+
+        /// @brief Header of the binary cache file.
+        /// Layout: header, `entryCount` entries, `namesSize` bytes of names.
+        struct CacheHeader {
+            char magic[4]; // "BCSY"
+            uint32_t version; // CACHE_VERSION
+            uint64_t sourceHash; // Hash of the bindings text the cache was compiled from
+            uint64_t sourceSize; // Size of the bindings text
+            int64_t sourceModified; // Last write time of the bindings file when the cache was compiled
+            uint32_t entryCount;
+            uint32_t namesSize;
+        };
+
+        static constexpr uint32_t CACHE_VERSION = 2;
+
+        /// @brief Add a symbol to the table.
+        /// @note `finalize` must be called after all symbols were added.
+        void add(uintptr_t address, std::string_view name);
+
+        /// @brief Sort the entries by address. If an address is present more than once, the last added name is kept.
+        void finalize();
+
+        /// @brief Find the symbol with the largest start address that is less than or equal to the given address.
+        /// @param address The address to search for (relative to the module base)
+        /// @return The found entry, or nullptr if there are no symbols before the address.
+        [[nodiscard]] const Entry *find(uintptr_t address) const;
+
+        /// @brief Get the name of an entry.
+        [[nodiscard]] std::string_view getName(const Entry &entry) const;
+
+        [[nodiscard]] size_t size() const { return m_entryCount; }
+        [[nodiscard]] bool empty() const { return m_entryCount == 0; }
+
+        /// @brief Parse bindings text ("name - 0xaddress" per line).
+        /// @note The table takes ownership of the text and references the names inside it without copying.
+        static SymbolTable parse(std::string text);
+
+        /// @brief Hash used to detect a stale cache (64-bit FNV-1a).
+        static uint64_t hash(std::string_view text);
+
+        /// @brief Get the size and modification time of a file.
+        /// @return The stamp, or std::nullopt if the file doesn't exist.
+        static std::optional<SourceStamp> getSourceStamp(const std::filesystem::path &path);
+
+        /// @brief Write the table into a binary cache file.
+        /// @param path Path of the cache file
+        /// @param source The bindings text the table was parsed from
+        /// @param stamp Stamp of the bindings file, taken before the text was read
+        /// @return Whether the file was written successfully.
+        bool saveCache(const std::filesystem::path &path, std::string_view source, SourceStamp stamp) const;
+
+        /// @brief Memory-map a binary cache file and use it without parsing.
+        /// The cache is current if the bindings file still has the size and modification time it was compiled
+        /// from, so the text is not read at all. Only if the stamp differs, the text is hashed to tell an
+        /// untouched file (e.g. restored from a backup) from a changed one.
+        /// @param path Path of the cache file
+        /// @param sourcePath Path of the bindings file the cache has to match
+        /// @return The table, or std::nullopt if the cache is missing, invalid or stale.
+        static std::optional<SymbolTable> loadCache(const std::filesystem::path &path,
+                                                    const std::filesystem::path &sourcePath);
+
+        /// @brief Get the path of the cache file for a version of a bindings file.
+        /// The name includes the stamp (e.g. "Win64-2.206.4b4f1c-1a2b3c4d5e.bin"), so a new version of the bindings
+        /// never has to replace a cache file that is still mapped by an older table (which Windows doesn't allow).
+        static std::filesystem::path getCachePath(const std::filesystem::path &sourcePath, SourceStamp stamp);
+
+        /// @brief Delete the cache files of a bindings file, except the one for the given stamp.
+        /// Files that are still mapped by a table can't be deleted on Windows, they are removed by a later call.
+        /// @return Amount of deleted files.
+        static size_t removeStaleCaches(const std::filesystem::path &sourcePath, SourceStamp stamp);
+
+        /// @brief Compile a bindings text file into a binary cache file.
+        /// @return Whether the cache was written successfully.
+        static bool compileCache(const std::filesystem::path &textPath, const std::filesystem::path &cachePath);
+
+    private:
+        [[nodiscard]] const Entry *entries() const;
+        [[nodiscard]] std::string_view names() const;
+
+        std::vector<Entry> m_entries;
+        std::string m_names;
+        MappedFile m_cache;
+        size_t m_entryCount = 0;
+    };
+
+}
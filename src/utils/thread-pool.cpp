@@ -0,0 +1,100 @@
+#include "thread-pool.hpp"
+
+#include <algorithm>
+
+#include <Windows.h>
+
+namespace utils {
+
+    ThreadPool &ThreadPool::get() {
+        // Never destroyed, since the workers keep running until the process exits
+        static auto pool = new ThreadPool();
+        return *pool;
+    }
+
+    void ThreadPool::start(size_t workers) {
+        std::lock_guard jobLock(m_jobMutex);
+        if (!m_workers.empty()) return;
+
+        if (workers == 0) {
+            auto cores = std::thread::hardware_concurrency();
+            workers = cores > 1 ? cores - 1 : 1;
+        }
+        workers = std::min(workers, MAX_WORKERS);
+
+        std::lock_guard lock(m_mutex);
+        m_workers.reserve(workers);
+        for (size_t i = 0; i < workers; i++) {
+            m_workers.emplace_back([this] { workerLoop(); });
+            m_workers.back().detach();
+        }
+    }
+
+    size_t ThreadPool::size() const {
+        std::lock_guard lock(m_mutex);
+        return m_workers.size();
+    }
+
+    void ThreadPool::runTasks(const std::function<void(size_t)> &task, size_t count) {
+        size_t completed = 0;
+        for (size_t i = m_next++; i < count; i = m_next++) {
+            task(i);
+            completed++;
+        }
+        m_finished += completed;
+    }
+
+    void ThreadPool::workerLoop() {
+        SetThreadDescription(GetCurrentThread(), L"BetterCrashlogs Worker");
+
+        uint64_t generation = 0;
+        while (true) {
+            const std::function<void(size_t)> *task;
+            size_t count;
+            {
+                std::unique_lock lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_task != nullptr && m_generation != generation; });
+                generation = m_generation;
+                task = m_task;
+                count = m_count;
+                m_active++;
+            }
+
+            runTasks(*task, count);
+
+            {
+                std::lock_guard lock(m_mutex);
+                m_active--;
+            }
+            m_done.notify_all();
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task) {
+        if (count == 0) return;
+
+        std::lock_guard jobLock(m_jobMutex);
+        if (m_workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; i++) task(i);
+            return;
+        }
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_next = 0;
+            m_finished = 0;
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        runTasks(task, count);
+
+        // Wait until every worker left the job, so none of them touches `task` after returning
+        std::unique_lock lock(m_mutex);
+        m_done.wait(lock, [&] { return m_finished == count && m_active == 0; });
+        m_task = nullptr;
+    }
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+
+    /// @brief Fixed set of worker threads for splitting the analysis of independent values.
+    /// Threads are started ahead of time, since creating them inside the crash handler is slow (and risky).
+    class ThreadPool {
+    public:
+        /// @brief Upper bound for the amount of workers.
+        static constexpr size_t MAX_WORKERS = 8;
+
+        /// @brief Get the process-wide pool.
+        static ThreadPool &get();
+
+        /// @brief Start the workers, if they are not running yet.
+        /// @param workers Amount of workers, or 0 to use one less than the amount of CPU cores.
+        void start(size_t workers = 0);
+
+        /// @brief Amount of running workers.
+        [[nodiscard]] size_t size() const;
+
+        /// @brief Call `task(i)` for every i in [0, count) and wait until all calls are done.
+        /// The calling thread takes part as well, so this also works if the pool was never started.
+        /// @note Tasks must not throw, and must not call `parallelFor` themselves.
+        void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    private:
+        ThreadPool() = default;
+
+        void workerLoop();
+
+        /// @brief Run tasks of the current job until there are none left.
+        void runTasks(const std::function<void(size_t)> &task, size_t count);
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_jobMutex; // Only one job at a time
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_done;
+        const std::function<void(size_t)> *m_task = nullptr; // Current job, or nullptr
+        size_t m_count = 0;
+        uint64_t m_generation = 0; // Incremented for every job, so workers don't run one twice
+        size_t m_active = 0; // Workers that are running the current job
+        std::atomic<size_t> m_next = 0; // Next index to claim
+        std::atomic<size_t> m_finished = 0; // Amount of completed tasks
+    };
+
+}
@@ -0,0 +1,186 @@
+#include "test.hpp"
+
+#include <fstream>
+
+#include "crash-index.hpp"
+
+using utils::CrashIndex;
+
+TEST_CASE("missing index finds nothing") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+
+    CHECK(!index.find(42));
+    CHECK(!index.find(0));
+}
+
+TEST_CASE("recorded crashes are grouped by fingerprint") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+
+    CHECK(index.record(42, "crash-1.txt", 100));
+    CHECK(index.record(7, "crash-2.txt", 200));
+    auto bucket = index.record(42, "crash-3.txt", 300);
+    REQUIRE(bucket);
+    CHECK(bucket->count == 2);
+    CHECK(bucket->firstSeen == 100);
+    CHECK(bucket->lastSeen == 300);
+
+    auto found = index.find(42);
+    REQUIRE(found);
+    CHECK(found->count == 2);
+    CHECK(index.getFiles(*found) == std::vector<std::string>{"crash-3.txt", "crash-1.txt"});
+
+    found = index.find(7);
+    REQUIRE(found);
+    CHECK(index.getFiles(*found) == std::vector<std::string>{"crash-2.txt"});
+
+    CHECK(!index.find(43));
+}
+
+TEST_CASE("index is reopened from disk") {
+    tests::TempDirectory directory;
+    CrashIndex(directory.path()).record(42, "crash-1.txt", 100);
+    CrashIndex(directory.path()).record(42, "crash-2.txt", 200);
+
+    CrashIndex index(directory.path());
+    auto found = index.find(42);
+    REQUIRE(found);
+    CHECK(found->count == 2);
+    CHECK(index.getFiles(*found).size() == 2);
+}
+
+TEST_CASE("zero fingerprint is rejected") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+    CHECK(!index.record(0, "crash.txt", 100));
+}
+
+TEST_CASE("colliding fingerprints are probed") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+
+    // All of these hash to the same slot
+    for (uint64_t i = 1; i <= CrashIndex::MAX_PROBES; i++) {
+        CHECK(index.record(i * CrashIndex::SLOT_COUNT + 5, "crash.txt", static_cast<time_t>(i)));
+    }
+    for (uint64_t i = 1; i <= CrashIndex::MAX_PROBES; i++) {
+        CHECK(index.find(i * CrashIndex::SLOT_COUNT + 5));
+    }
+
+    // Once all probed slots are taken, the least recently seen bucket is replaced
+    uint64_t extra = (CrashIndex::MAX_PROBES + 1) * CrashIndex::SLOT_COUNT + 5;
+    CHECK(index.record(extra, "crash.txt", 1000));
+    CHECK(index.find(extra));
+    CHECK(!index.find(CrashIndex::SLOT_COUNT + 5));
+    CHECK(index.find(2 * CrashIndex::SLOT_COUNT + 5));
+}
+
+TEST_CASE("index with a different layout is recreated") {
+    tests::TempDirectory directory;
+    {
+        std::ofstream file(directory.path() / "buckets.idx", std::ios::binary);
+        file << "not an index";
+    }
+
+    CrashIndex index(directory.path());
+    CHECK(!index.find(42));
+    CHECK(index.record(42, "crash.txt", 100));
+    CHECK(index.find(42));
+}
+
+TEST_CASE("corrupted log stops the file list") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+    index.record(42, "crash-1.txt", 100);
+    auto bucket = index.record(42, "crash-2.txt", 200);
+    REQUIRE(bucket);
+
+    std::filesystem::resize_file(directory.path() / "buckets.log", sizeof(CrashIndex::LogRecord) + 4);
+    CHECK(index.getFiles(*bucket).empty());
+}
+
+TEST_CASE("compacted log keeps the most recent names of every bucket") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+    for (int i = 0; i < 40; i++) {
+        index.record(42, "crash-" + std::to_string(i) + ".txt", 100 + i);
+    }
+    index.record(7, "other.txt", 500);
+    auto sizeBefore = std::filesystem::file_size(directory.path() / "buckets.log");
+
+    REQUIRE(index.compact());
+    CHECK(std::filesystem::file_size(directory.path() / "buckets.log") < sizeBefore);
+    CHECK(!std::filesystem::exists(directory.path() / "buckets.log.tmp"));
+
+    auto bucket = index.find(42);
+    REQUIRE(bucket);
+    CHECK(bucket->count == 40); // The crash count is kept
+    CHECK(bucket->firstSeen == 100);
+    auto files = index.getFiles(*bucket);
+    REQUIRE(files.size() == CrashIndex::MAX_FILES_PER_BUCKET);
+    CHECK(files.front() == "crash-39.txt");
+    CHECK(files.back() == "crash-24.txt");
+
+    bucket = index.find(7);
+    REQUIRE(bucket);
+    CHECK(index.getFiles(*bucket) == std::vector<std::string>{"other.txt"});
+
+    // New records are appended to the compacted log
+    bucket = index.record(42, "crash-40.txt", 200);
+    REQUIRE(bucket);
+    files = index.getFiles(*bucket);
+    CHECK(files.size() == CrashIndex::MAX_FILES_PER_BUCKET + 1);
+    CHECK(files.front() == "crash-40.txt");
+    CHECK(files.back() == "crash-24.txt");
+}
+
+TEST_CASE("log is compacted once it grows past the limit") {
+    tests::TempDirectory directory;
+    auto logPath = directory.path() / "buckets.log";
+    constexpr uint64_t limit = 4096;
+    CrashIndex index(directory.path(), limit);
+
+    // Without compaction, the log would be about ten times the limit
+    for (int i = 0; i < 1000; i++) {
+        auto bucket = index.record(42, "crash-" + std::to_string(i) + ".txt", 100 + i);
+        REQUIRE(bucket);
+        CHECK(bucket->count == static_cast<uint32_t>(i + 1));
+        CHECK(std::filesystem::file_size(logPath) <= limit);
+
+        auto files = index.getFiles(*bucket);
+        REQUIRE(!files.empty());
+        CHECK(files.front() == "crash-" + std::to_string(i) + ".txt");
+    }
+
+    auto bucket = index.find(42);
+    REQUIRE(bucket);
+    CHECK(bucket->count == 1000);
+    CHECK(index.getFiles(*bucket).size() >= CrashIndex::MAX_FILES_PER_BUCKET);
+}
+
+TEST_CASE("records of replaced buckets are dropped by compaction") {
+    tests::TempDirectory directory;
+    CrashIndex index(directory.path());
+
+    // Fill every probed slot, then replace the least recent bucket
+    for (uint64_t i = 0; i < CrashIndex::MAX_PROBES; i++) {
+        index.record(1 + i * CrashIndex::SLOT_COUNT, "old-" + std::to_string(i) + ".txt", 100 + static_cast<time_t>(i));
+    }
+    index.record(1 + CrashIndex::MAX_PROBES * CrashIndex::SLOT_COUNT, "new.txt", 1000);
+    CHECK(!index.find(1));
+
+    auto sizeBefore = std::filesystem::file_size(directory.path() / "buckets.log");
+    REQUIRE(index.compact());
+    auto recordSize = sizeof(CrashIndex::LogRecord) + std::string_view("old-0.txt").size();
+    CHECK(std::filesystem::file_size(directory.path() / "buckets.log") == sizeBefore - recordSize);
+
+    for (uint64_t i = 1; i < CrashIndex::MAX_PROBES; i++) {
+        auto bucket = index.find(1 + i * CrashIndex::SLOT_COUNT);
+        REQUIRE(bucket);
+        CHECK(index.getFiles(*bucket) == std::vector<std::string>{"old-" + std::to_string(i) + ".txt"});
+    }
+    auto bucket = index.find(1 + CrashIndex::MAX_PROBES * CrashIndex::SLOT_COUNT);
+    REQUIRE(bucket);
+    CHECK(index.getFiles(*bucket) == std::vector<std::string>{"new.txt"});
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Builds unwind.dll from unwind.s with the LLVM tools, for the pe-image tests.
+# llvm-mc assembles the code and writes the unwind info (.xdata/.pdata, including a chained entry).
+# This script applies the relocations and adds the export table, and yaml2obj writes the PE image.
+# Usage: make-unwind-dll.py [llvm bin directory]
+import os, struct, subprocess, sys
+
+here = os.path.dirname(os.path.abspath(__file__))
+tools = sys.argv[1] if len(sys.argv) > 1 else ''
+tool = lambda name: os.path.join(tools, name) if tools else name
+
+obj_path = os.path.join(here, 'unwind.obj')
+subprocess.check_call([tool('llvm-mc'), '-triple', 'x86_64-pc-windows-msvc', '-x86-asm-syntax=intel',
+                       '-filetype=obj', os.path.join(here, 'unwind.s'), '-o', obj_path])
+obj = open(obj_path, 'rb').read()
+os.remove(obj_path)
+
+# COFF object: sections, symbols and relocations
+_, section_count, _, symbols_offset, symbol_count, optional_size, _ = struct.unpack_from('<HHIIIHH', obj, 0)
+sections = {}
+for i in range(section_count):
+    offset = 20 + optional_size + i * 40
+    name = obj[offset:offset + 8].rstrip(b'\0').decode()
+    _, _, raw_size, raw_offset, relocations_offset, _, relocation_count, _, _ = struct.unpack_from('<IIIIIIHHI', obj, offset + 8)
+    sections[i + 1] = dict(name=name, data=bytearray(obj[raw_offset:raw_offset + raw_size]),
+                           relocations=[struct.unpack_from('<IIH', obj, relocations_offset + r * 10) for r in range(relocation_count)])
+
+symbols = {}
+i = 0
+while i < symbol_count:
+    offset = symbols_offset + i * 18
+    name = obj[offset:offset + 8].rstrip(b'\0').decode()
+    value, section, _, storage, aux = struct.unpack_from('<IhHBB', obj, offset + 8)
+    symbols[i] = dict(name=name, value=value, section=section, external=storage == 2)
+    i += 1 + aux
+
+by_name = {s['name']: i for i, s in sections.items()}
+text, xdata, pdata = by_name['.text'], by_name['.xdata'], by_name['.pdata']
+
+# Image layout: .text, .rdata (unwind info, then the export table), .pdata
+TEXT_RVA, RDATA_RVA, PDATA_RVA = 0x1000, 0x2000, 0x3000
+EXPORTS_OFFSET = (len(sections[xdata]['data']) + 15) & ~15
+rva = {text: TEXT_RVA, xdata: RDATA_RVA, pdata: PDATA_RVA}
+
+IMAGE_REL_AMD64_ADDR32NB = 3
+for index in (xdata, pdata):
+    section = sections[index]
+    for address, symbol, kind in section['relocations']:
+        assert kind == IMAGE_REL_AMD64_ADDR32NB, kind
+        target = symbols[symbol]
+        addend = struct.unpack_from('<I', section['data'], address)[0]
+        struct.pack_into('<I', section['data'], address, rva[target['section']] + target['value'] + addend)
+
+# Export directory with the external functions, sorted by name
+exports = sorted((s['name'], TEXT_RVA + s['value']) for s in symbols.values() if s['external'] and s['section'] == text)
+base = RDATA_RVA + EXPORTS_OFFSET
+functions = base + 40
+names = functions + 4 * len(exports)
+ordinals = names + 4 * len(exports)
+strings = ordinals + 2 * len(exports)
+blob = bytearray()
+name_rvas = []
+for string in ['unwind.dll'] + [name for name, _ in exports]:
+    name_rvas.append(strings + len(blob))
+    blob += string.encode() + b'\0'
+edata = struct.pack('<IIHHIIIIIII', 0, 0, 0, 0, name_rvas[0], 1, len(exports), len(exports), functions, names, ordinals)
+edata += b''.join(struct.pack('<I', address) for _, address in exports)
+edata += b''.join(struct.pack('<I', address) for address in name_rvas[1:])
+edata += b''.join(struct.pack('<H', i) for i in range(len(exports)))
+edata += blob
+
+rdata = bytes(sections[xdata]['data']).ljust(EXPORTS_OFFSET, b'\0') + edata
+yaml = f'''--- !COFF
+OptionalHeader:
+  AddressOfEntryPoint: 0
+  ImageBase: 0x180000000
+  SectionAlignment: 4096
+  FileAlignment: 512
+  MajorOperatingSystemVersion: 6
+  MinorOperatingSystemVersion: 0
+  MajorImageVersion: 0
+  MinorImageVersion: 0
+  MajorSubsystemVersion: 6
+  MinorSubsystemVersion: 0
+  Subsystem: IMAGE_SUBSYSTEM_WINDOWS_GUI
+  DLLCharacteristics: [ IMAGE_DLL_CHARACTERISTICS_HIGH_ENTROPY_VA, IMAGE_DLL_CHARACTERISTICS_NX_COMPAT ]
+  SizeOfStackReserve: 1048576
+  SizeOfStackCommit: 4096
+  SizeOfHeapReserve: 1048576
+  SizeOfHeapCommit: 4096
+  ExportTable:
+    RelativeVirtualAddress: {base:#x}
+    Size: {len(edata)}
+  ExceptionTable:
+    RelativeVirtualAddress: {PDATA_RVA:#x}
+    Size: {len(sections[pdata]['data'])}
+header:
+  Machine: IMAGE_FILE_MACHINE_AMD64
+  Characteristics: [ IMAGE_FILE_EXECUTABLE_IMAGE, IMAGE_FILE_LARGE_ADDRESS_AWARE, IMAGE_FILE_DLL ]
+sections:
+  - Name: .text
+    Characteristics: [ IMAGE_SCN_CNT_CODE, IMAGE_SCN_MEM_EXECUTE, IMAGE_SCN_MEM_READ ]
+    VirtualAddress: {TEXT_RVA:#x}
+    VirtualSize: {len(sections[text]['data'])}
+    SectionData: {sections[text]['data'].hex()}
+  - Name: .rdata
+    Characteristics: [ IMAGE_SCN_CNT_INITIALIZED_DATA, IMAGE_SCN_MEM_READ ]
+    VirtualAddress: {RDATA_RVA:#x}
+    VirtualSize: {len(rdata)}
+    SectionData: {rdata.hex()}
+  - Name: .pdata
+    Characteristics: [ IMAGE_SCN_CNT_INITIALIZED_DATA, IMAGE_SCN_MEM_READ ]
+    VirtualAddress: {PDATA_RVA:#x}
+    VirtualSize: {len(sections[pdata]['data'])}
+    SectionData: {sections[pdata]['data'].hex()}
+symbols: []
+...
+'''
+subprocess.run([tool('yaml2obj'), '-o', os.path.join(here, 'unwind.dll')], input=yaml.encode(), check=True)
@@ -0,0 +1,47 @@
+# Source of unwind.dll, used by pe-image-test (rebuild it with make-unwind-dll.py).
+# "split" has its tail in a chained unwind entry, "leaf" has no unwind info at all.
+
+    .text
+    .globl  leaf
+    .p2align 4
+leaf:
+    lea     eax, [rcx + 1]
+    ret
+
+    .globl  framed
+    .p2align 4
+    .seh_proc framed
+framed:
+    push    rbx
+    .seh_pushreg rbx
+    sub     rsp, 32
+    .seh_stackalloc 32
+    .seh_endprologue
+    mov     ebx, ecx
+    call    leaf
+    add     eax, ebx
+    add     rsp, 32
+    pop     rbx
+    ret
+    .seh_endproc
+
+    .globl  split
+    .p2align 4
+    .seh_proc split
+split:
+    push    rbp
+    .seh_pushreg rbp
+    .seh_endprologue
+    test    ecx, ecx
+    jz      split_tail
+    xor     eax, eax
+    pop     rbp
+    ret
+    .seh_startchained
+    .seh_endprologue
+split_tail:
+    mov     eax, 1
+    pop     rbp
+    ret
+    .seh_endchained
+    .seh_endproc
@@ -0,0 +1,220 @@
+#include "test.hpp"
+
+#include <random>
+#include <string_view>
+
+#include "frame-compression.hpp"
+
+using utils::FrameRun;
+using utils::KeptFrame;
+using utils::RawFrame;
+
+namespace {
+
+    /// @brief Build a stack from a pattern, every character is the address of a function.
+    std::vector<RawFrame> makeFrames(std::string_view pattern) {
+        std::vector<RawFrame> frames;
+        for (size_t i = 0; i < pattern.size(); i++) {
+            frames.push_back({static_cast<uintptr_t>(pattern[i]), 0x1000 + i * 0x10});
+        }
+        return frames;
+    }
+
+    /// @brief Stack of `count` different functions.
+    void addPlain(std::vector<RawFrame> &frames, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            frames.push_back({0x100000 + frames.size(), 0});
+        }
+    }
+
+    /// @brief Recursion through `length` functions, repeated `count` times.
+    void addCycle(std::vector<RawFrame> &frames, size_t length, size_t count, uintptr_t base = 0x200000) {
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = 0; j < length; j++) {
+                frames.push_back({base + j, 0});
+            }
+        }
+    }
+
+    /// @brief Lines of the collapsed trace, a cycle counts as many lines as it has frames.
+    size_t countLines(const std::vector<FrameRun> &runs) {
+        size_t lines = 0;
+        for (const auto &run: runs) lines += run.length;
+        return lines;
+    }
+
+    /// @brief Every frame is either kept, a repeat of a kept cycle, or omitted.
+    size_t countFrames(const std::vector<KeptFrame> &kept) {
+        size_t frames = 0;
+        for (const auto &frame: kept) {
+            frames += 1 + frame.repeatLength * frame.repeatCount + frame.skippedFrames;
+        }
+        return frames;
+    }
+
+}
+
+TEST_CASE("plain frames are merged into one run") {
+    CHECK(utils::compressFrames({}).empty());
+    CHECK(utils::compressFrames(makeFrames("A")) == std::vector<FrameRun>{{0, 1, 0}});
+    CHECK(utils::compressFrames(makeFrames("ABCDEF")) == std::vector<FrameRun>{{0, 6, 0}});
+    CHECK(utils::compressFrames(makeFrames("ABA")) == std::vector<FrameRun>{{0, 3, 0}});
+}
+
+TEST_CASE("recursion is collapsed") {
+    CHECK(utils::compressFrames(makeFrames("XAAAAY")) == std::vector<FrameRun>{{0, 1, 0}, {1, 1, 3}, {5, 1, 0}});
+    CHECK(utils::compressFrames(makeFrames("XABABABY")) == std::vector<FrameRun>{{0, 1, 0}, {1, 2, 2}, {7, 1, 0}});
+    CHECK(utils::compressFrames(makeFrames("ABCABC")) == std::vector<FrameRun>{{0, 3, 1}});
+
+    // Two different cycles right after each other
+    CHECK(utils::compressFrames(makeFrames("AAABCBC")) == std::vector<FrameRun>{{0, 1, 2}, {3, 2, 1}});
+}
+
+TEST_CASE("overlapping cycles of different lengths") {
+    // "AA" is a cycle of one frame, but "AAB" repeated covers more of the stack
+    CHECK(utils::compressFrames(makeFrames("AABAABAAB")) == std::vector<FrameRun>{{0, 3, 2}});
+    // "ABAB" repeated once covers as much as "AB" repeated three times, the shorter cycle wins
+    CHECK(utils::compressFrames(makeFrames("ABABABAB")) == std::vector<FrameRun>{{0, 2, 3}});
+    // Same for a single frame repeated
+    CHECK(utils::compressFrames(makeFrames("AAAA")) == std::vector<FrameRun>{{0, 1, 3}});
+    // The longer cycle only covers more frames once it repeats
+    CHECK(utils::compressFrames(makeFrames("AABCAABC")) == std::vector<FrameRun>{{0, 4, 1}});
+    CHECK(utils::compressFrames(makeFrames("AABCD")) == std::vector<FrameRun>{{0, 1, 1}, {2, 3, 0}});
+}
+
+TEST_CASE("cycles up to MAX_CYCLE_LENGTH are detected") {
+    std::vector<RawFrame> frames;
+    addCycle(frames, utils::MAX_CYCLE_LENGTH, 3);
+    CHECK(utils::compressFrames(frames) == std::vector<FrameRun>{{0, utils::MAX_CYCLE_LENGTH, 2}});
+
+    frames.clear();
+    addCycle(frames, utils::MAX_CYCLE_LENGTH + 1, 3);
+    CHECK(utils::compressFrames(frames) == std::vector<FrameRun>{{0, (utils::MAX_CYCLE_LENGTH + 1) * 3, 0}});
+}
+
+TEST_CASE("deep recursion") {
+    // Stack overflow: 90k frames of recursion through three functions, on top of the usual frames
+    std::vector<RawFrame> frames;
+    addPlain(frames, 5);
+    addCycle(frames, 3, 30000);
+    addPlain(frames, 20);
+    REQUIRE(frames.size() == 90025);
+
+    auto runs = utils::compressFrames(frames);
+    CHECK(runs == std::vector<FrameRun>{{0, 5, 0}, {5, 3, 29999}, {90005, 20, 0}});
+
+    // The whole stack fits, so nothing is omitted
+    auto kept = utils::selectFrames(runs);
+    REQUIRE(kept.size() == 28);
+    CHECK(kept[7] == KeptFrame{7, 3, 29999, 0});
+    CHECK(kept[8].index == 90005);
+    CHECK(countFrames(kept) == frames.size());
+}
+
+TEST_CASE("short traces are kept whole") {
+    for (size_t count: {0, 1, 10, 64, 127, 128}) {
+        std::vector<RawFrame> frames;
+        addPlain(frames, count);
+        auto kept = utils::selectFrames(utils::compressFrames(frames));
+        REQUIRE(kept.size() == count);
+        for (size_t i = 0; i < count; i++) {
+            CHECK(kept[i] == KeptFrame{i, 0, 0, 0});
+        }
+    }
+}
+
+TEST_CASE("head and tail of long traces are kept") {
+    for (size_t count: {129, 200, 5000}) {
+        std::vector<RawFrame> frames;
+        addPlain(frames, count);
+        auto kept = utils::selectFrames(utils::compressFrames(frames));
+        REQUIRE(kept.size() == utils::STACK_TRACE_KEEP * 2);
+        CHECK(kept[63] == KeptFrame{63, 0, 0, count - 128});
+        CHECK(kept[64].index == count - 64);
+        CHECK(kept.back().index == count - 1);
+        CHECK(kept.back().skippedFrames == 0);
+        CHECK(countFrames(kept) == count);
+    }
+
+    // A smaller amount to keep
+    std::vector<RawFrame> frames;
+    addPlain(frames, 10);
+    auto kept = utils::selectFrames(utils::compressFrames(frames), 2);
+    CHECK(kept == std::vector<KeptFrame>{{0, 0, 0, 0}, {1, 0, 0, 6}, {8, 0, 0, 0}, {9, 0, 0, 0}});
+}
+
+TEST_CASE("omitted cycles are counted with all their repeats") {
+    std::vector<RawFrame> frames;
+    addPlain(frames, 100);
+    addCycle(frames, 2, 11);
+    addPlain(frames, 100);
+
+    auto runs = utils::compressFrames(frames);
+    REQUIRE(countLines(runs) == 202);
+    auto kept = utils::selectFrames(runs);
+    REQUIRE(kept.size() == 128);
+    // Lines 64..99, the 22 frames of the cycle, then lines 102..137
+    CHECK(kept[63].skippedFrames == 36 + 22 + 36);
+    CHECK(kept[64] == KeptFrame{158, 0, 0, 0});
+    CHECK(countFrames(kept) == frames.size());
+}
+
+TEST_CASE("cycles crossing the boundaries are kept whole") {
+    // The cycle starts on the last two lines of the head
+    std::vector<RawFrame> frames;
+    addPlain(frames, 62);
+    addCycle(frames, 4, 6);
+    addPlain(frames, 200);
+
+    auto kept = utils::selectFrames(utils::compressFrames(frames));
+    REQUIRE(kept.size() == 62 + 4 + 64);
+    CHECK(kept[64] == KeptFrame{64, 0, 0, 0});
+    CHECK(kept[65] == KeptFrame{65, 4, 5, 136});
+    CHECK(kept[66].index == 86 + 136);
+    CHECK(countFrames(kept) == frames.size());
+
+    // The cycle ends on the first two lines of the tail
+    frames.clear();
+    addPlain(frames, 100);
+    addCycle(frames, 4, 4);
+    addPlain(frames, 62);
+
+    kept = utils::selectFrames(utils::compressFrames(frames));
+    REQUIRE(kept.size() == 64 + 4 + 62);
+    CHECK(kept[63] == KeptFrame{63, 0, 0, 36});
+    CHECK(kept[64].index == 100);
+    CHECK(kept[67] == KeptFrame{103, 4, 3, 0});
+    CHECK(kept[68].index == 116);
+    CHECK(countFrames(kept) == frames.size());
+}
+
+TEST_CASE("random stacks") {
+    std::mt19937 random(3);
+    for (int iteration = 0; iteration < 200; iteration++) {
+        std::vector<RawFrame> frames;
+        while (frames.size() < 2000) {
+            if (random() % 2) addPlain(frames, random() % 50);
+            else addCycle(frames, 1 + random() % 20, 1 + random() % 40, 0x200000 + random() % 4 * 8);
+        }
+
+        // The runs cover the stack in order, and expanding them gives back the same addresses
+        auto runs = utils::compressFrames(frames);
+        size_t next = 0;
+        for (const auto &run: runs) {
+            REQUIRE(run.first == next);
+            REQUIRE(run.length > 0);
+            REQUIRE(run.repeats == 0 || run.length <= utils::MAX_CYCLE_LENGTH);
+            for (size_t i = 0; i < run.length * (run.repeats + 1); i++) {
+                REQUIRE(frames[next + i].address == frames[run.first + i % run.length].address);
+            }
+            next += run.length * (run.repeats + 1);
+        }
+        REQUIRE(next == frames.size());
+
+        auto kept = utils::selectFrames(runs);
+        REQUIRE(countFrames(kept) == frames.size());
+        for (size_t i = 1; i < kept.size(); i++) {
+            REQUIRE(kept[i - 1].index < kept[i].index);
+        }
+    }
+}
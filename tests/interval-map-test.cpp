@@ -0,0 +1,122 @@
+#include "test.hpp"
+
+#include <string>
+
+#include "interval-map.hpp"
+
+using utils::IntervalMap;
+
+TEST_CASE("empty map finds nothing") {
+    IntervalMap<int> map;
+    CHECK(map.empty());
+    CHECK(map.find(0) == nullptr);
+    CHECK(map.find(0x1000) == nullptr);
+    CHECK(map.find(UINTPTR_MAX) == nullptr);
+    CHECK(map.findExact(0x1000) == nullptr);
+    CHECK(!map.erase(0x1000));
+}
+
+TEST_CASE("begin is inclusive and end is exclusive") {
+    IntervalMap<int> map;
+    map.insert(0x1000, 0x2000, 1);
+
+    CHECK(map.find(0xFFF) == nullptr);
+    REQUIRE(map.find(0x1000) != nullptr);
+    CHECK(map.find(0x1000)->value == 1);
+    REQUIRE(map.find(0x1FFF) != nullptr);
+    CHECK(map.find(0x1FFF)->value == 1);
+    CHECK(map.find(0x2000) == nullptr);
+}
+
+TEST_CASE("adjacent intervals don't overlap") {
+    IntervalMap<int> map;
+    map.insert(0x2000, 0x3000, 2);
+    map.insert(0x1000, 0x2000, 1);
+    map.insert(0x3000, 0x4000, 3);
+
+    CHECK(map.find(0x1FFF)->value == 1);
+    CHECK(map.find(0x2000)->value == 2);
+    CHECK(map.find(0x2FFF)->value == 2);
+    CHECK(map.find(0x3000)->value == 3);
+    CHECK(map.find(0x4000) == nullptr);
+}
+
+TEST_CASE("gaps between intervals find nothing") {
+    IntervalMap<int> map;
+    map.insert(0x5000, 0x6000, 2);
+    map.insert(0x1000, 0x2000, 1);
+
+    CHECK(map.find(0x2000) == nullptr);
+    CHECK(map.find(0x4FFF) == nullptr);
+    CHECK(map.find(0x5000)->value == 2);
+    CHECK(map.find(0x6000) == nullptr);
+}
+
+TEST_CASE("intervals are kept sorted") {
+    IntervalMap<int> map;
+    for (uintptr_t i: {7, 3, 9, 1, 5}) {
+        map.insert(i * 0x1000, i * 0x1000 + 0x800, static_cast<int>(i));
+    }
+
+    CHECK(map.size() == 5);
+    uintptr_t previous = 0;
+    for (const auto &interval: map) {
+        CHECK(interval.begin > previous);
+        previous = interval.begin;
+    }
+    for (uintptr_t i: {1, 3, 5, 7, 9}) {
+        CHECK(map.find(i * 0x1000 + 0x7FF)->value == static_cast<int>(i));
+        CHECK(map.find(i * 0x1000 + 0x800) == nullptr);
+    }
+}
+
+TEST_CASE("inserting at the same start replaces the interval") {
+    IntervalMap<std::string> map;
+    map.insert(0x1000, 0x2000, "old.dll");
+    map.insert(0x1000, 0x1800, "new.dll");
+
+    CHECK(map.size() == 1);
+    CHECK(map.find(0x17FF)->value == "new.dll");
+    CHECK(map.find(0x1800) == nullptr);
+    REQUIRE(map.findExact(0x1000) != nullptr);
+    CHECK(map.findExact(0x1000)->end == 0x1800);
+    CHECK(map.findExact(0x1001) == nullptr);
+}
+
+TEST_CASE("unloaded modules can be reloaded at another address") {
+    // Same steps as ModuleRegistry::refresh
+    IntervalMap<std::string> map;
+    map.insert(0x10000, 0x20000, "a.dll");
+    map.insert(0x20000, 0x30000, "b.dll");
+    map.insert(0x40000, 0x50000, "c.dll");
+
+    auto removed = map.retain([](const auto &interval) { return interval.value != "b.dll"; });
+    CHECK(removed == 1);
+    CHECK(map.size() == 2);
+    CHECK(map.find(0x20000) == nullptr);
+    CHECK(map.find(0x10000)->value == "a.dll");
+    CHECK(map.find(0x40000)->value == "c.dll");
+
+    map.insert(0x30000, 0x40000, "b.dll");
+    CHECK(map.find(0x20000) == nullptr);
+    CHECK(map.find(0x30000)->value == "b.dll");
+    CHECK(map.find(0x3FFFF)->value == "b.dll");
+
+    CHECK(map.erase(0x30000));
+    CHECK(!map.erase(0x30000));
+    CHECK(map.find(0x30000) == nullptr);
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.find(0x10000) == nullptr);
+}
+
+TEST_CASE("intervals at the ends of the address space") {
+    IntervalMap<int> map;
+    map.insert(0, 0x1000, 1);
+    map.insert(UINTPTR_MAX - 0xFFF, UINTPTR_MAX, 2);
+
+    CHECK(map.find(0)->value == 1);
+    CHECK(map.find(UINTPTR_MAX - 1)->value == 2);
+    CHECK(map.find(UINTPTR_MAX) == nullptr);
+}
@@ -0,0 +1,279 @@
+#include "test.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+
+#include "pe-image.hpp"
+
+using namespace utils::pe;
+
+namespace {
+
+    template <typename T>
+    void put(std::vector<uint8_t> &data, size_t offset, T value) {
+        std::memcpy(data.data() + offset, &value, sizeof(T));
+    }
+
+    void putString(std::vector<uint8_t> &data, size_t offset, std::string_view str) {
+        std::memcpy(data.data() + offset, str.data(), str.size());
+    }
+
+    constexpr uint32_t SIZE_OF_IMAGE = 0x3000;
+    constexpr uint32_t TEXT_RVA = 0x1000, TEXT_RAW = 0x400;
+    constexpr uint32_t RDATA_RVA = 0x2000, RDATA_RAW = 0x600;
+
+    /// @brief Build a PE32+ file with a code section, and a data section with the export and exception directories.
+    std::vector<uint8_t> buildFile() {
+        std::vector<uint8_t> file(0x800);
+        put<uint16_t>(file, 0, 0x5A4D);
+        put<uint32_t>(file, 0x3C, 0x80);
+        put<uint32_t>(file, 0x80, 0x4550);
+
+        // File header
+        put<uint16_t>(file, 0x84, 0x8664);
+        put<uint16_t>(file, 0x86, 2);
+        put<uint16_t>(file, 0x94, 0xF0);
+
+        // Optional header
+        put<uint16_t>(file, 0x98, 0x20B);
+        put<uint64_t>(file, 0x98 + 24, 0x140000000);
+        put<uint32_t>(file, 0x98 + 56, SIZE_OF_IMAGE);
+        put<uint32_t>(file, 0x98 + 108, 16);
+        put<uint32_t>(file, 0x98 + 112, RDATA_RVA); // Export
+        put<uint32_t>(file, 0x98 + 116, 0x100);
+        put<uint32_t>(file, 0x98 + 136, RDATA_RVA + 0x100); // Exception
+        put<uint32_t>(file, 0x98 + 140, 5 * 12);
+
+        // Section headers
+        size_t section = 0x98 + 0xF0;
+        putString(file, section, ".text");
+        put<uint32_t>(file, section + 8, 0x100);
+        put<uint32_t>(file, section + 12, TEXT_RVA);
+        put<uint32_t>(file, section + 16, 0x200);
+        put<uint32_t>(file, section + 20, TEXT_RAW);
+        put<uint32_t>(file, section + 36, 0x60000020);
+
+        section += 40;
+        putString(file, section, ".rdata");
+        put<uint32_t>(file, section + 8, 0x200);
+        put<uint32_t>(file, section + 12, RDATA_RVA);
+        put<uint32_t>(file, section + 16, 0x200);
+        put<uint32_t>(file, section + 20, RDATA_RAW);
+        put<uint32_t>(file, section + 36, 0x40000040);
+
+        // Export directory: a function, a data export and a forwarded export
+        auto rdata = [](uint32_t rva) { return rva - RDATA_RVA + RDATA_RAW; };
+        put<uint32_t>(file, rdata(0x2000 + 20), 3);
+        put<uint32_t>(file, rdata(0x2000 + 24), 3);
+        put<uint32_t>(file, rdata(0x2000 + 28), 0x2040);
+        put<uint32_t>(file, rdata(0x2000 + 32), 0x2050);
+        put<uint32_t>(file, rdata(0x2000 + 36), 0x2060);
+        put<uint32_t>(file, rdata(0x2040), 0x1010);
+        put<uint32_t>(file, rdata(0x2044), 0x2180);
+        put<uint32_t>(file, rdata(0x2048), 0x20D0);
+        put<uint32_t>(file, rdata(0x2050), 0x20A0);
+        put<uint32_t>(file, rdata(0x2054), 0x20B0);
+        put<uint32_t>(file, rdata(0x2058), 0x20C0);
+        put<uint16_t>(file, rdata(0x2060), 0);
+        put<uint16_t>(file, rdata(0x2062), 1);
+        put<uint16_t>(file, rdata(0x2064), 2);
+        putString(file, rdata(0x20A0), "function");
+        putString(file, rdata(0x20B0), "data");
+        putString(file, rdata(0x20C0), "forwarded");
+        putString(file, rdata(0x20D0), "other.dll.function");
+
+        // Exception directory: a function at [0x1000, 0x1040), and parts of it that have to be folded back to it
+        auto putFunction = [&](uint32_t rva, uint32_t begin, uint32_t end, uint32_t unwindInfo) {
+            put<uint32_t>(file, rdata(rva), begin);
+            put<uint32_t>(file, rdata(rva + 4), end);
+            put<uint32_t>(file, rdata(rva + 8), unwindInfo);
+        };
+        putFunction(0x2100, 0x1000, 0x1040, 0x2140); // Primary
+        putFunction(0x210C, 0x1040, 0x1060, 0x2150); // Chained to the primary entry
+        putFunction(0x2118, 0x1060, 0x1070, 0x2100 | 1); // Indirect, points to the primary entry
+        putFunction(0x2124, 0x1070, 0x1080, 0x2170); // Chained to itself
+        putFunction(0x2130, 0x1080, 0x10A0, 0x2190); // Chained to the chained entry, after 3 unwind codes
+
+        // UNWIND_INFO: version 1, flags << 3, prolog size, code count, frame register, codes, chained entry
+        put<uint8_t>(file, rdata(0x2140), 0x01);
+        put<uint8_t>(file, rdata(0x2150), 0x21);
+        putFunction(0x2154, 0x1000, 0x1040, 0x2140);
+        put<uint8_t>(file, rdata(0x2170), 0x21);
+        putFunction(0x2174, 0x1070, 0x1080, 0x2170);
+        put<uint8_t>(file, rdata(0x2190), 0x21);
+        put<uint8_t>(file, rdata(0x2192), 3);
+        putFunction(0x219C, 0x1040, 0x1060, 0x2150); // Code count is padded to an even number
+
+        // Code
+        put<uint8_t>(file, TEXT_RAW + 0x10, 0xCC);
+        return file;
+    }
+
+    /// @brief Place the sections of the file at their virtual addresses, like the loader does.
+    std::vector<uint8_t> mapFile(const std::vector<uint8_t> &file) {
+        std::vector<uint8_t> mapped(SIZE_OF_IMAGE);
+        std::memcpy(mapped.data(), file.data(), 0x400);
+        std::memcpy(mapped.data() + TEXT_RVA, file.data() + TEXT_RAW, 0x100);
+        std::memcpy(mapped.data() + RDATA_RVA, file.data() + RDATA_RAW, 0x200);
+        return mapped;
+    }
+
+    void checkImage(const Image &image) {
+        CHECK(image.is64());
+        CHECK(image.imageBase() == 0x140000000);
+        CHECK(image.sizeOfImage() == SIZE_OF_IMAGE);
+        REQUIRE(image.sections().size() == 2);
+        CHECK(std::string_view(image.sections()[0].name) == ".text");
+        CHECK(image.sections()[0].isExecutable());
+        CHECK(!image.sections()[1].isExecutable());
+
+        auto exports = image.functionExports();
+        REQUIRE(exports.size() == 1);
+        CHECK(exports[0].rva == 0x1010);
+        CHECK(std::string_view(exports[0].name) == "function");
+
+        auto code = image.read<uint8_t>(0x1010);
+        CHECK(code && *code == 0xCC);
+
+        CHECK(image.runtimeFunctionCount() == 5);
+        auto function = image.findFunction(0x1010);
+        REQUIRE(function);
+        CHECK(function->begin == 0x1000);
+        CHECK(function->end == 0x1040);
+        CHECK(!image.findFunction(0x10A0));
+        CHECK(!image.findFunction(0x0FFF));
+    }
+
+    void checkFunction(const Image &image, uint32_t rva, std::optional<std::pair<uint32_t, uint32_t>> expected) {
+        auto function = image.findFunction(rva);
+        REQUIRE(function.has_value() == expected.has_value());
+        if (function) {
+            CHECK(function->begin == expected->first);
+            CHECK(function->end == expected->second);
+        }
+    }
+
+}
+
+TEST_CASE("file layout is parsed from the raw offsets") {
+    auto file = buildFile();
+    auto image = Image::fromFile(file);
+    REQUIRE(image);
+    checkImage(*image);
+
+    // Outside of any section
+    CHECK(!image->read<uint8_t>(TEXT_RVA + 0x200));
+}
+
+TEST_CASE("memory layout is parsed from the virtual addresses") {
+    auto mapped = mapFile(buildFile());
+    auto image = Image::fromMemory(mapped.data());
+    REQUIRE(image);
+    checkImage(*image);
+}
+
+TEST_CASE("chained and indirect entries are folded to the primary entry") {
+    auto file = buildFile();
+    auto image = Image::fromFile(file);
+    REQUIRE(image);
+
+    std::pair<uint32_t, uint32_t> primary{0x1000, 0x1040};
+    checkFunction(*image, 0x1000, primary);
+    checkFunction(*image, 0x1040, primary); // UNW_FLAG_CHAININFO
+    checkFunction(*image, 0x105F, primary);
+    checkFunction(*image, 0x1060, primary); // Indirect RUNTIME_FUNCTION
+    checkFunction(*image, 0x1090, primary); // Two chained entries
+
+    // The raw entries are not folded
+    auto entry = image->findRuntimeFunction(0x1065);
+    REQUIRE(entry);
+    CHECK(entry->beginAddress == 0x1060);
+    CHECK(entry->unwindInfoAddress == (0x2100 | 1));
+}
+
+TEST_CASE("chain loops are cut off") {
+    auto file = buildFile();
+    auto image = Image::fromFile(file);
+    REQUIRE(image);
+
+    // The entry at [0x1070, 0x1080) chains to itself, which has to stop at MAX_CHAIN_DEPTH
+    CHECK(image->findRuntimeFunction(0x1075));
+    checkFunction(*image, 0x1075, std::nullopt);
+}
+
+TEST_CASE("chains pointing outside of the image are rejected") {
+    auto file = buildFile();
+    put<uint32_t>(file, RDATA_RAW + 0x154 + 8, 0x9000); // Chained entry of [0x1040, 0x1060)
+    put<uint32_t>(file, RDATA_RAW + 0x118 + 8, 0x8001); // Indirect entry
+    auto image = Image::fromFile(file);
+    REQUIRE(image);
+
+    checkFunction(*image, 0x1000, std::pair<uint32_t, uint32_t>{0x1000, 0x1040});
+    checkFunction(*image, 0x1050, std::nullopt);
+    checkFunction(*image, 0x1065, std::nullopt);
+    checkFunction(*image, 0x1090, std::nullopt);
+}
+
+TEST_CASE("invalid files are rejected") {
+    auto file = buildFile();
+
+    CHECK(!Image::fromFile({}));
+    CHECK(!Image::fromFile(std::span(file).first(0x40)));
+    CHECK(!Image::fromFile(std::span(file).first(0x100)));
+
+    auto badSignature = file;
+    put<uint32_t>(badSignature, 0x80, 0);
+    CHECK(!Image::fromFile(badSignature));
+
+    auto badMagic = file;
+    put<uint16_t>(badMagic, 0x98, 0x1234);
+    CHECK(!Image::fromFile(badMagic));
+}
+
+TEST_CASE("truncated sections read nothing") {
+    auto file = buildFile();
+    auto image = Image::fromFile(std::span(file).first(RDATA_RAW + 0x10));
+    REQUIRE(image);
+    CHECK(image->functionExports().empty());
+    CHECK(!image->findFunction(0x1010));
+    CHECK(image->read<uint8_t>(0x1010));
+}
+
+TEST_CASE("DLL built by the LLVM tools") {
+    // See tests/fixtures/unwind.s
+    std::ifstream stream(std::filesystem::path(FIXTURES_DIR) / "unwind.dll", std::ios::binary);
+    std::vector<uint8_t> file{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    auto image = Image::fromFile(file);
+    REQUIRE(image);
+
+    CHECK(image->is64());
+    CHECK(image->imageBase() == 0x180000000);
+    CHECK(image->sizeOfImage() == 0x4000);
+    REQUIRE(image->sections().size() == 3);
+    CHECK(image->sections()[0].isExecutable());
+    CHECK(image->runtimeFunctionCount() == 3);
+
+    auto exports = image->functionExports();
+    REQUIRE(exports.size() == 3);
+    CHECK(std::string_view(exports[0].name) == "framed");
+    CHECK(exports[0].rva == 0x1010);
+    CHECK(std::string_view(exports[1].name) == "leaf");
+    CHECK(exports[1].rva == 0x1000);
+    CHECK(std::string_view(exports[2].name) == "split");
+    CHECK(exports[2].rva == 0x1030);
+
+    // Leaf functions have no unwind info
+    checkFunction(*image, 0x1000, std::nullopt);
+    checkFunction(*image, 0x1010, std::pair<uint32_t, uint32_t>{0x1010, 0x1024});
+    checkFunction(*image, 0x1023, std::pair<uint32_t, uint32_t>{0x1010, 0x1024});
+    checkFunction(*image, 0x1024, std::nullopt);
+
+    // The tail of "split" has its own chained entry
+    auto tail = image->findRuntimeFunction(0x103A);
+    REQUIRE(tail);
+    CHECK(tail->beginAddress == 0x1039);
+    checkFunction(*image, 0x1030, std::pair<uint32_t, uint32_t>{0x1030, 0x1040});
+    checkFunction(*image, 0x103A, std::pair<uint32_t, uint32_t>{0x1030, 0x1040});
+}
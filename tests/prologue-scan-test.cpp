@@ -0,0 +1,148 @@
+#include "test.hpp"
+
+#include <array>
+#include <random>
+
+#include "prologue-scan.hpp"
+
+using namespace utils::mem;
+
+namespace {
+
+    constexpr std::array KERNELS = {ScanKernel::Scalar, ScanKernel::SSE2, ScanKernel::AVX2};
+    constexpr uint8_t PROLOGUES[] = {0x40, 0x48, 0xE9};
+
+    /// @brief Compare every kernel against the scalar reference.
+    bool checkKernels(const uint8_t *low, const uint8_t *high, std::span<const uint8_t> prologues = PROLOGUES) {
+        auto expected = findLastPrologueScalar(low, high, prologues);
+        bool same = CHECK(findLastPrologue(low, high, prologues) == expected);
+        for (auto kernel: KERNELS) {
+            same &= CHECK(findLastPrologue(low, high, prologues, kernel) == expected);
+        }
+        return same;
+    }
+
+    /// @brief Fill the buffer with random bytes, which never form a match on their own.
+    void fillNoise(std::mt19937 &random, uint8_t *data, size_t size) {
+        for (size_t i = 0; i < size; i++) {
+            uint8_t byte;
+            do {
+                byte = static_cast<uint8_t>(random());
+            } while (byte == 0xCC);
+            data[i] = byte;
+        }
+    }
+
+}
+
+TEST_CASE("scalar reference finds the last pair") {
+    uint8_t data[] = {0xCC, 0x48, 0x00, 0xCC, 0x40, 0xCC, 0xCC, 0x90, 0xCC};
+    CHECK(findLastPrologueScalar(data, data + sizeof(data), PROLOGUES) == data + 4);
+    CHECK(findLastPrologueScalar(data, data + 4, PROLOGUES) == data + 1);
+    CHECK(findLastPrologueScalar(data, data + 1, PROLOGUES) == nullptr);
+    CHECK(findLastPrologueScalar(data + 2, data + 4, PROLOGUES) == nullptr);
+    CHECK(findLastPrologueScalar(data, data, PROLOGUES) == nullptr);
+}
+
+TEST_CASE("every pair position and buffer size") {
+    // Covers the tails of both kernels and pairs split between two 16 or 32-byte blocks
+    std::mt19937 random(1);
+    std::vector<uint8_t> buffer(160);
+    for (size_t size = 0; size <= 130; size++) {
+        fillNoise(random, buffer.data(), buffer.size());
+        REQUIRE(checkKernels(buffer.data(), buffer.data() + size));
+
+        for (size_t position = 0; position + 1 < size; position++) {
+            fillNoise(random, buffer.data(), buffer.size());
+            buffer[position] = 0xCC;
+            buffer[position + 1] = PROLOGUES[position % std::size(PROLOGUES)];
+            REQUIRE(checkKernels(buffer.data(), buffer.data() + size));
+
+            // A padding byte right before the end, without the prologue byte inside the buffer
+            buffer[size - 1] = 0xCC;
+            buffer[size] = PROLOGUES[0];
+            REQUIRE(checkKernels(buffer.data(), buffer.data() + size));
+        }
+    }
+}
+
+TEST_CASE("random buffers with many matches") {
+    std::mt19937 random(2);
+    std::vector<uint8_t> buffer(0x1100);
+    const uint8_t alphabet[] = {0xCC, 0x40, 0x48, 0xE9, 0x55, 0x00};
+
+    for (int iteration = 0; iteration < 2000; iteration++) {
+        // Few distinct bytes, so padding bytes and prologue bytes are next to each other a lot
+        for (auto &byte: buffer) {
+            byte = random() % 8 < 6 ? static_cast<uint8_t>(random()) : alphabet[random() % std::size(alphabet)];
+        }
+        size_t offset = random() % 64;
+        size_t size = random() % (buffer.size() - offset);
+        REQUIRE(checkKernels(buffer.data() + offset, buffer.data() + offset + size));
+    }
+}
+
+TEST_CASE("padding without a prologue byte is not a match") {
+    std::vector<uint8_t> buffer(300, 0xCC);
+    CHECK(checkKernels(buffer.data(), buffer.data() + buffer.size()));
+    CHECK(findLastPrologue(buffer.data(), buffer.data() + buffer.size(), PROLOGUES) == nullptr);
+
+    buffer[100] = 0x48;
+    CHECK(checkKernels(buffer.data(), buffer.data() + buffer.size()));
+    CHECK(findLastPrologue(buffer.data(), buffer.data() + buffer.size(), PROLOGUES) == buffer.data() + 100);
+}
+
+TEST_CASE("prologue sets of every size") {
+    std::mt19937 random(3);
+    std::vector<uint8_t> buffer(500);
+    const uint8_t prologues[] = {0x40, 0x48, 0xE9, 0x55, 0x53};
+
+    for (size_t count = 0; count <= std::size(prologues); count++) {
+        std::span<const uint8_t> subset(prologues, count);
+        for (int iteration = 0; iteration < 200; iteration++) {
+            for (auto &byte: buffer) {
+                byte = random() % 2 ? 0xCC : prologues[random() % std::size(prologues)];
+            }
+            size_t size = random() % buffer.size();
+            REQUIRE(checkKernels(buffer.data(), buffer.data() + size, subset));
+        }
+    }
+}
+
+TEST_CASE("scan never reads outside of the range") {
+    // Both ends of the range are next to inaccessible pages, so an out-of-bounds load crashes the test
+    tests::GuardedPages pages(2);
+    std::mt19937 random(4);
+    fillNoise(random, pages.begin(), pages.end() - pages.begin());
+
+    for (size_t size = 0; size <= 200; size++) {
+        REQUIRE(checkKernels(pages.end() - size, pages.end()));
+        REQUIRE(checkKernels(pages.begin(), pages.begin() + size));
+    }
+
+    pages.begin()[0] = 0xCC;
+    pages.begin()[1] = 0x48;
+    pages.end()[-2] = 0xCC;
+    pages.end()[-1] = 0xE9;
+    for (size_t size = 2; size <= 200; size++) {
+        REQUIRE(checkKernels(pages.end() - size, pages.end()));
+        REQUIRE(checkKernels(pages.begin(), pages.begin() + size));
+    }
+    CHECK(findLastPrologue(pages.begin(), pages.end(), PROLOGUES) == pages.end() - 1);
+}
+
+TEST_CASE("unsupported kernels fall back to a supported one") {
+    std::vector<uint8_t> buffer(100, 0x90);
+    buffer[10] = 0xCC;
+    buffer[11] = 0x40;
+    auto expected = buffer.data() + 11;
+
+    // Requesting AVX2 on a CPU without it has to take the SSE2 path (and the scalar one on other architectures)
+    for (auto kernel: KERNELS) {
+        CHECK(findLastPrologue(buffer.data(), buffer.data() + buffer.size(), PROLOGUES, kernel) == expected);
+    }
+
+#if defined(__x86_64__) || defined(_M_X64)
+    CHECK(getBestScanKernel() >= ScanKernel::SSE2);
+#endif
+}
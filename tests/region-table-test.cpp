@@ -0,0 +1,143 @@
+#include "test.hpp"
+
+#include "region-table.hpp"
+
+using utils::mem::RegionAccess;
+using utils::mem::RegionTable;
+
+namespace {
+
+    constexpr RegionAccess READ_ONLY{true, false, false};
+    constexpr RegionAccess READ_WRITE{true, true, false};
+    constexpr RegionAccess READ_EXECUTE{true, false, true};
+    constexpr RegionAccess GUARD{false, true, false}; // PAGE_GUARD or PAGE_NOACCESS
+
+    /// @brief Regions of a typical module and a thread stack, as VirtualQuery reports them (in ascending order).
+    RegionTable buildTable() {
+        RegionTable table;
+        // Module: headers, .text, .rdata, .data
+        table.add(0x10000, 0x1000, READ_ONLY);
+        table.add(0x11000, 0x4000, READ_EXECUTE);
+        table.add(0x15000, 0x2000, READ_ONLY);
+        table.add(0x17000, 0x1000, READ_WRITE);
+        // Gap at [0x18000, 0x20000)
+        // Stack: guard page, then the committed part (reported as two regions)
+        table.add(0x20000, 0x1000, GUARD);
+        table.add(0x21000, 0x1000, READ_WRITE);
+        table.add(0x22000, 0x2000, READ_WRITE);
+        return table;
+    }
+
+}
+
+TEST_CASE("empty table knows no memory") {
+    RegionTable table;
+    CHECK(table.empty());
+    CHECK(table.find(0x1000) == nullptr);
+    CHECK(!table.isReadable(0x1000));
+    CHECK(!table.isReadable(0x1000, 16));
+    CHECK(!table.isExecutable(0x1000));
+    CHECK(table.readableRange(0x1000) == std::pair<uintptr_t, uintptr_t>{0, 0});
+    CHECK(table.getReadableSize(0x1000, 16) == 0);
+}
+
+TEST_CASE("adjacent regions with the same access are merged") {
+    auto table = buildTable();
+
+    // The two stack regions become one, the module sections stay apart
+    CHECK(table.size() == 6);
+
+    RegionTable merged;
+    merged.add(0x1000, 0x1000, READ_WRITE);
+    merged.add(0x2000, 0x1000, READ_WRITE);
+    merged.add(0x3000, 0x1000, READ_WRITE);
+    CHECK(merged.size() == 1);
+    CHECK(merged.isReadable(0x3FFF));
+
+    // Not merged over a gap or with different access
+    merged.add(0x5000, 0x1000, READ_WRITE);
+    merged.add(0x6000, 0x1000, READ_ONLY);
+    CHECK(merged.size() == 3);
+    CHECK(!merged.isReadable(0x4000));
+
+    // Empty regions are ignored
+    merged.add(0x7000, 0, READ_ONLY);
+    CHECK(merged.size() == 3);
+    CHECK(!merged.isReadable(0x7000));
+}
+
+TEST_CASE("access at region boundaries") {
+    auto table = buildTable();
+
+    CHECK(!table.isReadable(0xFFFF));
+    CHECK(table.isReadable(0x10000));
+    CHECK(!table.isExecutable(0x10FFF));
+    CHECK(table.isExecutable(0x11000));
+    CHECK(table.isExecutable(0x14FFF));
+    CHECK(!table.isExecutable(0x15000));
+    CHECK(table.find(0x17000) && table.find(0x17000)->writable);
+    CHECK(table.isReadable(0x17FFF));
+    CHECK(!table.isReadable(0x18000));
+    CHECK(table.find(0x18000) == nullptr);
+
+    // Guard pages are committed, but not readable
+    CHECK(table.find(0x20000) != nullptr);
+    CHECK(!table.isReadable(0x20000));
+    CHECK(!table.isReadable(0x20FFF));
+    CHECK(table.isReadable(0x21000));
+    CHECK(table.isReadable(0x23FFF));
+    CHECK(!table.isReadable(0x24000));
+}
+
+TEST_CASE("readable range spans adjacent readable regions") {
+    auto table = buildTable();
+    using Range = std::pair<uintptr_t, uintptr_t>;
+
+    // The whole module is readable, regardless of the other rights
+    CHECK(table.readableRange(0x10000) == Range{0x10000, 0x18000});
+    CHECK(table.readableRange(0x12345) == Range{0x10000, 0x18000});
+    CHECK(table.readableRange(0x17FFF) == Range{0x10000, 0x18000});
+
+    // Gaps and guard pages split the ranges
+    CHECK(table.readableRange(0x18000) == Range{0, 0});
+    CHECK(table.readableRange(0x20000) == Range{0, 0});
+    CHECK(table.readableRange(0x21000) == Range{0x21000, 0x24000});
+}
+
+TEST_CASE("readable size stops at gaps and guard pages") {
+    auto table = buildTable();
+
+    CHECK(table.getReadableSize(0x10000, 0x100) == 0x100);
+    CHECK(table.getReadableSize(0x10FF0, 0x100) == 0x100); // Across two regions
+    CHECK(table.getReadableSize(0x14F00, 0x10000) == 0x3100); // Up to the gap
+    CHECK(table.getReadableSize(0x17FFF, 0x100) == 1);
+    CHECK(table.getReadableSize(0x18000, 0x100) == 0);
+    CHECK(table.getReadableSize(0x20FF0, 0x100) == 0); // Inside the guard page
+    CHECK(table.getReadableSize(0x21000, 0x10000) == 0x3000);
+    CHECK(table.getReadableSize(0x23FF0, 0x100) == 0x10);
+    CHECK(table.getReadableSize(0x10000, 0) == 0);
+}
+
+TEST_CASE("readable check of a whole range") {
+    auto table = buildTable();
+
+    CHECK(table.isReadable(0x10000, 0x8000));
+    CHECK(table.isReadable(0x14FF8, 16));
+    CHECK(!table.isReadable(0x17FF8, 16)); // Into the gap
+    CHECK(!table.isReadable(0x10000, 0x8001));
+    CHECK(!table.isReadable(0x1FFF8, 16)); // Into the guard page
+    CHECK(table.isReadable(0x21000, 0x3000));
+    CHECK(table.isReadable(0x21000, 0));
+    CHECK(!table.isReadable(0x20000, 0));
+    CHECK(!table.isReadable(0x21000, SIZE_MAX)); // Overflow
+}
+
+TEST_CASE("region at the end of the address space") {
+    RegionTable table;
+    table.add(UINTPTR_MAX - 0x1FFF, 0x1000, READ_ONLY);
+
+    CHECK(table.isReadable(UINTPTR_MAX - 0x1FFF));
+    CHECK(!table.isReadable(UINTPTR_MAX - 0xFFF));
+    CHECK(table.getReadableSize(UINTPTR_MAX - 0x1FFF, SIZE_MAX) == 0x1000);
+    CHECK(!table.isReadable(UINTPTR_MAX - 0x10, 0x100));
+}
@@ -0,0 +1,94 @@
+#include "test.hpp"
+
+#include <string>
+#include <thread>
+
+#include "string-arena.hpp"
+
+using utils::StringArena;
+
+TEST_CASE("equal strings are stored once") {
+    StringArena arena;
+    std::string first = "geode.dll";
+    std::string second = "geode.dll";
+
+    auto a = arena.intern(first);
+    auto b = arena.intern(second);
+    CHECK(a == "geode.dll");
+    CHECK(a.data() == b.data());
+    CHECK(a.data() != first.data());
+    CHECK(arena.count() == 1);
+    CHECK(arena.allocated() >= first.size());
+
+    arena.intern("GeometryDash.exe");
+    CHECK(arena.count() == 2);
+}
+
+TEST_CASE("empty strings are not stored") {
+    StringArena arena;
+    CHECK(arena.intern("").empty());
+    CHECK(arena.count() == 0);
+    CHECK(arena.allocated() == 0);
+}
+
+TEST_CASE("views stay valid when new blocks are allocated") {
+    StringArena arena;
+    auto first = arena.intern("first");
+
+    // Larger than a block, and enough small strings to fill a few more
+    std::string large(100 * 1024, 'x');
+    auto interned = arena.intern(large);
+    for (int i = 0; i < 20000; i++) {
+        arena.intern("string #" + std::to_string(i));
+    }
+
+    CHECK(first == "first");
+    CHECK(interned == large);
+    CHECK(arena.count() == 20002);
+    CHECK(arena.allocated() >= large.size());
+    CHECK(arena.intern("string #123").data() == arena.intern(std::string("string #123")).data());
+}
+
+TEST_CASE("interning from several threads") {
+    StringArena arena;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                arena.intern("module" + std::to_string(i));
+            }
+        });
+    }
+    for (auto &thread: threads) thread.join();
+
+    CHECK(arena.count() == 1000);
+}
+
+TEST_CASE("cleared arena starts over") {
+    StringArena arena;
+    for (int i = 0; i < 10000; i++) {
+        arena.intern("name #" + std::to_string(i));
+    }
+    REQUIRE(arena.allocated() > 0);
+
+    arena.clear();
+    CHECK(arena.count() == 0);
+    CHECK(arena.allocated() == 0);
+
+    auto name = arena.intern("name #1");
+    CHECK(name == "name #1");
+    CHECK(arena.count() == 1);
+    CHECK(arena.intern(std::string("name #1")).data() == name.data());
+}
+
+TEST_CASE("global and analysis arenas are separate") {
+    auto module = utils::intern("geode.dll");
+    auto function = utils::internSymbol("geode.dll");
+    CHECK(module.data() != function.data());
+
+    auto count = utils::getStringArena().count();
+    utils::getAnalysisArena().clear();
+    CHECK(utils::getAnalysisArena().count() == 0);
+    CHECK(utils::getStringArena().count() == count);
+    CHECK(module == "geode.dll");
+}
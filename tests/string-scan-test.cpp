@@ -0,0 +1,212 @@
+#include "test.hpp"
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "string-scan.hpp"
+
+using namespace utils::mem;
+
+namespace {
+
+    const uint8_t *bytes(std::string_view str) {
+        return reinterpret_cast<const uint8_t *>(str.data());
+    }
+
+    /// @brief Compare the SIMD scan against the scalar reference.
+    bool checkScan(const uint8_t *data, size_t size) {
+        return CHECK(scanCString(data, size) == scanCStringScalar(data, size));
+    }
+
+    bool checkScan(std::string_view str) {
+        return checkScan(bytes(str), str.size());
+    }
+
+    std::optional<size_t> scan(std::string_view str) {
+        checkScan(str);
+        return scanCString(bytes(str), str.size());
+    }
+
+    // Valid sequences of every length, and ones that must be rejected
+    const std::string_view VALID[] = {"\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80", "\xC2\xA0", "\xF4\x8F\xBF\xBF"};
+    const std::string_view INVALID[] = {
+            "\x80", // Lone continuation byte
+            "\xC0\x80", "\xC1\xBF", "\xE0\x80\x80", "\xF0\x80\x80\x80", // Overlong
+            "\xED\xA0\x80", // Surrogate
+            "\xF4\x90\x80\x80", "\xF5\x80\x80\x80", "\xFF", // Above U+10FFFF
+            "\xC2\x80", "\xC2\x9F", // C1 control characters
+            "\xE2\x82", "\xF0\x9F\x98", "\xC3", // Truncated
+            "\xE2\x28\xA1", // Bad continuation byte
+    };
+
+}
+
+TEST_CASE("scalar reference") {
+    CHECK(scanCStringScalar(bytes("hello"), 6) == 5);
+    CHECK(scanCStringScalar(bytes(std::string_view("", 1)), 1) == 0);
+    CHECK(!scanCStringScalar(bytes("hello"), 5)); // No terminator
+    CHECK(scanCStringScalar(bytes("a\tb\r\n"), 6) == 5);
+    CHECK(!scanCStringScalar(bytes("a\x01"), 3));
+    CHECK(!scanCStringScalar(bytes("a\x7F"), 3));
+    CHECK(!scanCStringScalar(nullptr, 0));
+}
+
+TEST_CASE("terminator at every offset") {
+    std::mt19937 random(1);
+    for (size_t length = 0; length < 100; length++) {
+        std::string str;
+        for (size_t i = 0; i < length; i++) str += static_cast<char>(0x20 + random() % 0x5F);
+        str += '\0';
+        str += "trailing data after the terminator";
+
+        for (size_t size = length + 1; size <= str.size(); size++) {
+            REQUIRE(checkScan(bytes(str), size));
+            CHECK(scanCString(bytes(str), size) == length);
+        }
+        REQUIRE(checkScan(bytes(str), length)); // Terminator outside of the buffer
+        CHECK(!scanCString(bytes(str), length));
+    }
+}
+
+TEST_CASE("multibyte characters at every offset") {
+    // Covers sequences split between two 16-byte blocks, and the vector loop resuming after one
+    for (auto sequence: VALID) {
+        for (size_t offset = 0; offset < 40; offset++) {
+            std::string str(offset, 'a');
+            str += sequence;
+            str += std::string(20, 'b');
+            str += '\0';
+            REQUIRE(checkScan(str));
+            CHECK(scan(str) == str.size() - 1);
+        }
+    }
+
+    for (auto sequence: INVALID) {
+        for (size_t offset = 0; offset < 40; offset++) {
+            std::string str(offset, 'a');
+            str += sequence;
+            str += std::string(20, 'b');
+            str += '\0';
+            REQUIRE(checkScan(str));
+            CHECK(!scan(str));
+        }
+    }
+}
+
+TEST_CASE("control characters at every offset") {
+    for (int byte = 1; byte < 0x80; byte++) {
+        bool allowed = byte >= 0x20 && byte != 0x7F || byte == '\t' || byte == '\n' || byte == '\r';
+        for (size_t offset = 0; offset < 40; offset++) {
+            std::string str(60, 'a');
+            str[offset] = static_cast<char>(byte);
+            str += '\0';
+            REQUIRE(checkScan(str));
+            CHECK(scan(str).has_value() == allowed);
+        }
+    }
+}
+
+TEST_CASE("random buffers") {
+    std::mt19937 random(2);
+    std::string buffer(300, '\0');
+    for (int iteration = 0; iteration < 20000; iteration++) {
+        // Mostly printable ASCII, with some UTF-8 lead and continuation bytes and the odd control byte
+        for (auto &c: buffer) {
+            auto kind = random() % 100;
+            if (kind < 85) c = static_cast<char>(0x20 + random() % 0x5F);
+            else if (kind < 97) c = static_cast<char>(0x80 + random() % 0x80);
+            else if (kind < 99) c = static_cast<char>(random() % 0x20);
+            else c = '\0';
+        }
+        size_t offset = random() % 32;
+        size_t size = random() % (buffer.size() - offset);
+        REQUIRE(checkScan(bytes(buffer) + offset, size));
+    }
+}
+
+TEST_CASE("scan stops at the end of the readable memory") {
+    tests::GuardedPages pages(1);
+    auto end = pages.end();
+
+    // No terminator before the inaccessible page
+    for (size_t size = 0; size <= 100; size++) {
+        std::fill(end - size, end, 'a');
+        REQUIRE(checkScan(end - size, size));
+        CHECK(!scanCString(end - size, size));
+    }
+
+    // Terminator in the last byte
+    end[-1] = 0;
+    for (size_t size = 1; size <= 100; size++) {
+        REQUIRE(checkScan(end - size, size));
+        CHECK(scanCString(end - size, size) == size - 1);
+    }
+
+    // Multibyte character cut off by the end of the page
+    for (auto sequence: VALID) {
+        for (size_t cut = 1; cut < sequence.size(); cut++) {
+            for (size_t padding = 0; padding < 40; padding++) {
+                auto start = end - padding - cut;
+                std::fill(start, start + padding, 'a');
+                std::memcpy(start + padding, sequence.data(), cut);
+                REQUIRE(checkScan(start, padding + cut));
+                CHECK(!scanCString(start, padding + cut));
+            }
+        }
+    }
+}
+
+TEST_CASE("strings are limited to MAX_STRING_LENGTH") {
+    std::string longest(MAX_STRING_LENGTH - 1, 'a');
+    longest += '\0';
+    CHECK(scanCString(bytes(longest), MAX_STRING_LENGTH) == MAX_STRING_LENGTH - 1);
+    CHECK(checkScan(bytes(longest), MAX_STRING_LENGTH));
+
+    std::string tooLong(MAX_STRING_LENGTH, 'a');
+    tooLong += '\0';
+    CHECK(!scanCString(bytes(tooLong), MAX_STRING_LENGTH));
+    CHECK(checkScan(bytes(tooLong), MAX_STRING_LENGTH));
+}
+
+TEST_CASE("wide strings") {
+    auto scanWide = [](std::u16string_view str) { return scanWideString(str.data(), str.size()); };
+    using namespace std::string_view_literals;
+
+    CHECK(scanWide(u"Hello\0"sv) == 5);
+    CHECK(scanWide(u"Tab\tand\r\nlines\0"sv) == 14);
+    CHECK(scanWide(u"Café\0"sv) == 4);
+    CHECK(scanWide(u"ab\U0001F600\0"sv) == 4); // Surrogate pair
+    CHECK(!scanWide(u"Hello"sv)); // No terminator
+    CHECK(!scanWide(u"A\0"sv)); // Too short
+    CHECK(!scanWide(u"\0"sv));
+    CHECK(!scanWide(u"a中文字\0"sv)); // Mostly non-ASCII, likely random data
+    CHECK(!scanWide(u"ab\x01\0"sv)); // Control character
+    CHECK(!scanWide(u"ab\u0085\0"sv)); // C1 control character
+    CHECK(!scanWide(u"ab\xD83D\0"sv)); // Unpaired high surrogate
+    CHECK(!scanWide(u"ab\xDE00\0"sv)); // Unpaired low surrogate
+    CHECK(!scanWide(u"ab\xFFFE\0"sv)); // Noncharacter
+
+    // High surrogate in the last code unit of the buffer
+    std::u16string_view cut = u"abc\xD83D"sv;
+    CHECK(!scanWideString(cut.data(), cut.size()));
+}
+
+TEST_CASE("wide strings are converted to UTF-8") {
+    auto convert = [](std::u16string_view str) { return wideToUtf8(str.data(), str.size()); };
+
+    CHECK(convert(u"") == "");
+    CHECK(convert(u"Hello") == "Hello");
+    CHECK(convert(u"Café") == "Caf\xC3\xA9");
+    CHECK(convert(u"€") == "\xE2\x82\xAC");
+    CHECK(convert(u"\U0001F600") == "\xF0\x9F\x98\x80");
+    CHECK(convert(u"a\xD83D" u"b") == "a\xEF\xBF\xBD" "b"); // Unpaired high surrogate
+    CHECK(convert(u"a\xDE00") == "a\xEF\xBF\xBD"); // Unpaired low surrogate
+    CHECK(convert(std::u16string_view(u"\xD83D\xDE00", 1)) == "\xEF\xBF\xBD"); // Pair cut by the length
+
+    // Everything the converter produces from a valid string is accepted by the UTF-8 scan
+    std::u16string wide = u"Mixed é€\U0001F600 text";
+    auto utf8 = convert(wide) + '\0';
+    CHECK(scan(utf8) == utf8.size() - 1);
+}
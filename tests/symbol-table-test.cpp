@@ -0,0 +1,237 @@
+#include "test.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "symbol-table.hpp"
+
+using utils::SymbolTable;
+
+namespace {
+
+    std::string readFile(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream stream;
+        stream << file.rdbuf();
+        return stream.str();
+    }
+
+    void writeFile(const std::filesystem::path &path, std::string_view data) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    /// @brief Check that both tables give the same result for every address around their symbols.
+    void checkSameLookups(const SymbolTable &expected, const SymbolTable &actual) {
+        REQUIRE(actual.size() == expected.size());
+
+        std::vector<uintptr_t> addresses = {0, 1, UINTPTR_MAX};
+        for (uintptr_t address = 0; address < 0x500000; address += 0x1000) {
+            addresses.push_back(address);
+        }
+        auto probe = [&](uintptr_t address) {
+            auto a = expected.find(address);
+            auto b = actual.find(address);
+            REQUIRE((a == nullptr) == (b == nullptr));
+            if (a) {
+                CHECK(a->address == b->address);
+                CHECK(expected.getName(*a) == actual.getName(*b));
+            }
+        };
+        for (auto address: addresses) probe(address);
+
+        // Every symbol boundary of the expected table
+        for (uintptr_t address: addresses) {
+            if (auto entry = expected.find(address)) {
+                probe(entry->address - 1);
+                probe(entry->address);
+                probe(entry->address + 1);
+            }
+        }
+    }
+
+    std::filesystem::path getFixturePath() {
+        return std::filesystem::path(FIXTURES_DIR) / "bindings.txt";
+    }
+
+}
+
+TEST_CASE("parser reads the bindings format") {
+    auto table = SymbolTable::parse(readFile(getFixturePath()));
+
+    auto find = [&](uintptr_t address) -> std::string_view {
+        auto entry = table.find(address);
+        return entry ? table.getName(*entry) : std::string_view{};
+    };
+
+    CHECK(table.size() == 23);
+    CHECK(find(0x7c5f).empty());
+    CHECK(find(0x7c60) == "AchievementManager::sharedState");
+    CHECK(find(0x7c61) == "AchievementManager::sharedState");
+    CHECK(find(0x3001d0) == "Duplicate::lastWins");
+    CHECK(find(0x4a0000) == "Uppercase::prefix");
+    CHECK(find(0x4b0000) == "NoPrefix::address");
+    CHECK(find(0x4c0000) == "Padded::address");
+    CHECK(find(0x4d0000) == "Windows::lineEnding");
+    CHECK(find(0x4e0000) == "Last::line");
+    CHECK(find(UINTPTR_MAX) == "Last::line");
+}
+
+TEST_CASE("cache gives the same lookups as the text parser") {
+    tests::TempDirectory directory;
+    auto cachePath = directory.path() / "bindings.bin";
+    auto text = readFile(getFixturePath());
+
+    REQUIRE(SymbolTable::compileCache(getFixturePath(), cachePath));
+    auto cache = SymbolTable::loadCache(cachePath, getFixturePath());
+    REQUIRE(cache);
+    checkSameLookups(SymbolTable::parse(text), *cache);
+}
+
+TEST_CASE("cache from the converter gives the same lookups as the text parser") {
+    // Written by the compile-symbol-cache test, which runs first
+    auto cache = SymbolTable::loadCache(CONVERTED_CACHE, getFixturePath());
+    REQUIRE(cache);
+    checkSameLookups(SymbolTable::parse(readFile(getFixturePath())), *cache);
+}
+
+TEST_CASE("cache of an updated bindings file is rebuilt") {
+    tests::TempDirectory directory;
+    auto textPath = directory.path() / "bindings.txt";
+    auto cachePath = directory.path() / "bindings.bin";
+
+    auto text = readFile(getFixturePath());
+    writeFile(textPath, text);
+    REQUIRE(SymbolTable::compileCache(textPath, cachePath));
+    auto modified = std::filesystem::last_write_time(textPath);
+
+    // A new download changes the size
+    auto updated = text + "Added::symbol - 0x4f0000\n";
+    writeFile(textPath, updated);
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+
+    REQUIRE(SymbolTable::compileCache(textPath, cachePath));
+    auto cache = SymbolTable::loadCache(cachePath, textPath);
+    REQUIRE(cache);
+    checkSameLookups(SymbolTable::parse(updated), *cache);
+
+    // Same size, but written later
+    updated = text;
+    updated.replace(updated.find("0x3001d0"), 8, "0x3001e0");
+    writeFile(textPath, updated);
+    std::filesystem::last_write_time(textPath, modified + std::chrono::seconds(10));
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+
+    REQUIRE(SymbolTable::compileCache(textPath, cachePath));
+    cache = SymbolTable::loadCache(cachePath, textPath);
+    REQUIRE(cache);
+    checkSameLookups(SymbolTable::parse(updated), *cache);
+}
+
+TEST_CASE("cache is checked against the file stamp") {
+    tests::TempDirectory directory;
+    auto textPath = directory.path() / "bindings.txt";
+    auto cachePath = directory.path() / "bindings.bin";
+
+    auto text = readFile(getFixturePath());
+    writeFile(textPath, text);
+    REQUIRE(SymbolTable::compileCache(textPath, cachePath));
+    auto modified = std::filesystem::last_write_time(textPath);
+
+    // Touched without changing the contents: the stamp differs, but the hash still matches
+    std::filesystem::last_write_time(textPath, modified + std::chrono::seconds(10));
+    CHECK(SymbolTable::loadCache(cachePath, textPath));
+
+    // With a matching stamp the text is not read at all, so a same-size edit with a restored time goes unnoticed
+    auto edited = text;
+    edited.replace(edited.find("0x3001d0"), 8, "0x3001e0");
+    writeFile(textPath, edited);
+    std::filesystem::last_write_time(textPath, modified);
+    CHECK(SymbolTable::loadCache(cachePath, textPath));
+
+    std::filesystem::remove(textPath);
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+}
+
+TEST_CASE("truncated or corrupted cache is rejected") {
+    tests::TempDirectory directory;
+    auto cachePath = directory.path() / "bindings.bin";
+    auto textPath = getFixturePath();
+    REQUIRE(SymbolTable::compileCache(textPath, cachePath));
+    auto cache = readFile(cachePath);
+
+    for (size_t size: {size_t(0), size_t(4), sizeof(SymbolTable::CacheHeader) - 1, sizeof(SymbolTable::CacheHeader),
+                       cache.size() / 2, cache.size() - 1}) {
+        writeFile(cachePath, std::string_view(cache).substr(0, size));
+        CHECK(!SymbolTable::loadCache(cachePath, textPath));
+    }
+
+    writeFile(cachePath, cache + "x");
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+
+    auto badMagic = cache;
+    badMagic[0] = 'X';
+    writeFile(cachePath, badMagic);
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+
+    auto badVersion = cache;
+    badVersion[4]++;
+    writeFile(cachePath, badVersion);
+    CHECK(!SymbolTable::loadCache(cachePath, textPath));
+
+    writeFile(cachePath, cache);
+    CHECK(SymbolTable::loadCache(cachePath, textPath));
+    CHECK(!SymbolTable::loadCache(directory.path() / "missing.bin", textPath));
+}
+
+TEST_CASE("every version of the bindings gets its own cache file") {
+    tests::TempDirectory directory;
+    auto textPath = directory.path() / "Win64-2.206.txt";
+    auto text = readFile(getFixturePath());
+    writeFile(textPath, text);
+
+    auto stamp = SymbolTable::getSourceStamp(textPath);
+    REQUIRE(stamp);
+    CHECK(stamp->size == text.size());
+    auto oldPath = SymbolTable::getCachePath(textPath, *stamp);
+    CHECK(oldPath.parent_path() == directory.path());
+    CHECK(oldPath.filename().string().starts_with("Win64-2.206."));
+    CHECK(oldPath.extension() == ".bin");
+    REQUIRE(SymbolTable::compileCache(textPath, oldPath));
+    auto oldTable = SymbolTable::loadCache(oldPath, textPath);
+    REQUIRE(oldTable);
+
+    // A new download doesn't touch the cache the old table still maps
+    writeFile(textPath, text + "Added::symbol - 0x4f0000\n");
+    auto newStamp = SymbolTable::getSourceStamp(textPath);
+    REQUIRE(newStamp);
+    auto newPath = SymbolTable::getCachePath(textPath, *newStamp);
+    CHECK(newPath != oldPath);
+    REQUIRE(SymbolTable::compileCache(textPath, newPath));
+    CHECK(SymbolTable::loadCache(newPath, textPath));
+    CHECK(!SymbolTable::loadCache(oldPath, textPath));
+
+    // Only the caches of the same bindings file are removed, the current one is kept
+    writeFile(directory.path() / "Win64-2.206.bin", "unversioned cache");
+    writeFile(directory.path() / "libcocos2d-2.206.bin", "other bindings");
+    writeFile(directory.path() / "Win64-2.206.notes.bin", "not a cache");
+    CHECK(SymbolTable::removeStaleCaches(textPath, *newStamp) == 2);
+    CHECK(!std::filesystem::exists(oldPath));
+    CHECK(!std::filesystem::exists(directory.path() / "Win64-2.206.bin"));
+    CHECK(std::filesystem::exists(newPath));
+    CHECK(std::filesystem::exists(textPath));
+    CHECK(std::filesystem::exists(directory.path() / "libcocos2d-2.206.bin"));
+    CHECK(std::filesystem::exists(directory.path() / "Win64-2.206.notes.bin"));
+    CHECK(SymbolTable::removeStaleCaches(textPath, *newStamp) == 0);
+
+    // The old table keeps working from its mapping
+    CHECK(oldTable->getName(*oldTable->find(0x7c60)) == "AchievementManager::sharedState");
+}
+
+TEST_CASE("empty and garbage bindings") {
+    CHECK(SymbolTable::parse("").empty());
+    CHECK(SymbolTable::parse("\n\n\n").empty());
+    CHECK(SymbolTable::parse("no separator\n - \nname - \nname - 0x").empty());
+    CHECK(SymbolTable::parse("name - 0x10").size() == 1);
+}
@@ -0,0 +1,16 @@
+#include "test.hpp"
+
+int main() {
+    int failedCases = 0;
+    for (const auto &testCase: tests::getTestCases()) {
+        auto failures = tests::getFailures();
+        testCase.body();
+        if (tests::getFailures() != failures) {
+            std::fprintf(stderr, "FAILED: %.*s\n", static_cast<int>(testCase.name.size()), testCase.name.data());
+            failedCases++;
+        }
+    }
+
+    std::printf("%zu test cases, %d failed\n", tests::getTestCases().size(), failedCases);
+    return failedCases == 0 ? 0 : 1;
+}
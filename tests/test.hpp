@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/// @brief Minimal test harness, so the tests can be built without any dependencies.
+/// Every test file defines its cases with TEST_CASE and is linked with test-main.cpp into its own executable.
+namespace tests {
+
+    struct TestCase {
+        std::string_view name;
+        std::function<void()> body;
+    };
+
+    inline std::vector<TestCase> &getTestCases() {
+        static std::vector<TestCase> cases;
+        return cases;
+    }
+
+    /// @brief Amount of failed checks in the current run.
+    inline int &getFailures() {
+        static int failures = 0;
+        return failures;
+    }
+
+    struct Registrar {
+        Registrar(std::string_view name, std::function<void()> body) {
+            getTestCases().push_back({name, std::move(body)});
+        }
+    };
+
+    inline bool check(bool condition, const char *expression, const char *file, int line) {
+        if (!condition) {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            getFailures()++;
+        }
+        return condition;
+    }
+
+    /// @brief Empty directory inside the system temp directory, removed with everything in it on destruction.
+    class TempDirectory {
+    public:
+        TempDirectory() {
+            std::random_device random;
+            auto name = "bcl-test-" + std::to_string(random()) + std::to_string(random());
+            m_path = std::filesystem::temp_directory_path() / name;
+            std::filesystem::create_directories(m_path);
+        }
+
+        ~TempDirectory() {
+            std::error_code error;
+            std::filesystem::remove_all(m_path, error);
+        }
+
+        TempDirectory(const TempDirectory &) = delete;
+        TempDirectory &operator=(const TempDirectory &) = delete;
+
+        [[nodiscard]] const std::filesystem::path &path() const { return m_path; }
+
+    private:
+        std::filesystem::path m_path;
+    };
+
+    /// @brief Readable pages surrounded by inaccessible ones, so reading outside of them crashes the test.
+    class GuardedPages {
+    public:
+        explicit GuardedPages(size_t pageCount) {
+#ifdef _WIN32
+            SYSTEM_INFO info;
+            GetSystemInfo(&info);
+            m_pageSize = info.dwPageSize;
+            m_size = (pageCount + 2) * m_pageSize;
+            m_base = static_cast<uint8_t *>(VirtualAlloc(nullptr, m_size, MEM_RESERVE, PAGE_NOACCESS));
+            VirtualAlloc(m_base + m_pageSize, pageCount * m_pageSize, MEM_COMMIT, PAGE_READWRITE);
+#else
+            m_pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            m_size = (pageCount + 2) * m_pageSize;
+            m_base = static_cast<uint8_t *>(mmap(nullptr, m_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            mprotect(m_base + m_pageSize, pageCount * m_pageSize, PROT_READ | PROT_WRITE);
+#endif
+            m_end = m_base + m_size - m_pageSize;
+        }
+
+        ~GuardedPages() {
+#ifdef _WIN32
+            VirtualFree(m_base, 0, MEM_RELEASE);
+#else
+            munmap(m_base, m_size);
+#endif
+        }
+
+        GuardedPages(const GuardedPages &) = delete;
+        GuardedPages &operator=(const GuardedPages &) = delete;
+
+        [[nodiscard]] uint8_t *begin() const { return m_base + m_pageSize; }
+        [[nodiscard]] uint8_t *end() const { return m_end; }
+
+    private:
+        uint8_t *m_base;
+        uint8_t *m_end;
+        size_t m_pageSize;
+        size_t m_size;
+    };
+
+}
+
+#define TESTS_CONCAT_IMPL(a, b) a##b
+#define TESTS_CONCAT(a, b) TESTS_CONCAT_IMPL(a, b)
+
+#define TEST_CASE(name) \
+    static void TESTS_CONCAT(testCase, __LINE__)(); \
+    static tests::Registrar TESTS_CONCAT(testRegistrar, __LINE__)(name, TESTS_CONCAT(testCase, __LINE__)); \
+    static void TESTS_CONCAT(testCase, __LINE__)()
+
+/// @brief Record a failure and keep going.
+#define CHECK(...) tests::check(static_cast<bool>(__VA_ARGS__), #__VA_ARGS__, __FILE__, __LINE__)
+
+/// @brief Record a failure and stop the test case.
+#define REQUIRE(...) do { if (!CHECK(__VA_ARGS__)) return; } while (false)
@@ -0,0 +1,39 @@
+#include <cstdio>
+#include <filesystem>
+
+#include "symbol-table.hpp"
+
+// Offline converter from a bindings text file to the binary symbol cache, which is the same file the mod compiles
+// after downloading the bindings. Useful to ship a prebuilt cache, or to inspect one outside of the game.
+// Usage: compile-symbol-cache <bindings.txt> [cache.bin]
+int main(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        std::fprintf(stderr, "Usage: %s <bindings.txt> [cache.bin]\n", argv[0]);
+        return 2;
+    }
+
+    std::filesystem::path textPath = argv[1];
+    auto stamp = utils::SymbolTable::getSourceStamp(textPath);
+    if (!stamp) {
+        std::fprintf(stderr, "Failed to read %s\n", textPath.string().c_str());
+        return 1;
+    }
+
+    // By default, use the name the mod looks for next to the bindings file
+    auto cachePath = argc == 3 ? std::filesystem::path(argv[2]) : utils::SymbolTable::getCachePath(textPath, *stamp);
+
+    if (!utils::SymbolTable::compileCache(textPath, cachePath)) {
+        std::fprintf(stderr, "Failed to compile %s into %s\n", textPath.string().c_str(), cachePath.string().c_str());
+        return 1;
+    }
+
+    // Read the cache back, so a broken file is never reported as a success
+    auto table = utils::SymbolTable::loadCache(cachePath, textPath);
+    if (!table) {
+        std::fprintf(stderr, "Compiled cache %s can't be loaded\n", cachePath.string().c_str());
+        return 1;
+    }
+
+    std::printf("%s: %zu symbols\n", cachePath.string().c_str(), table->size());
+    return 0;
+}
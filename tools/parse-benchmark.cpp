@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "symbol-table.hpp"
+
+// Compares the ways to load a bindings file at crash time: the old line-by-line parser (one std::string per line,
+// two substr copies and std::stoull, inserted into an unordered_map), SymbolTable::parse and the binary cache.
+// Usage: parse-benchmark [bindings.txt] (a synthetic 100k-line file is generated if no file is given)
+
+using utils::SymbolTable;
+
+static constexpr int ITERATIONS = 15;
+static constexpr size_t SYNTHETIC_LINES = 100000;
+
+// Parser used before SymbolTable, kept here as the baseline
+static std::unordered_map<uintptr_t, std::string> parseLineByLine(const std::filesystem::path &path) {
+    std::unordered_map<uintptr_t, std::string> functions;
+    std::ifstream file(path);
+    if (!file.is_open()) return functions;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        auto pos = line.find(" - ");
+        if (pos == std::string::npos) continue;
+        auto address = std::stoull(line.substr(pos + 3), nullptr, 16);
+        functions[address] = line.substr(0, pos);
+    }
+    return functions;
+}
+
+static SymbolTable parseMapped(const std::filesystem::path &path) {
+    utils::MappedFile text;
+    if (!text.open(path)) return {};
+    return SymbolTable::parse(std::string(text.view()));
+}
+
+static SymbolTable loadCache(const std::filesystem::path &path, const std::filesystem::path &cachePath) {
+    auto table = SymbolTable::loadCache(cachePath, path);
+    return table ? std::move(*table) : SymbolTable{};
+}
+
+static void writeSyntheticFile(const std::filesystem::path &path) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    for (size_t i = 0; i < SYNTHETIC_LINES; i++) {
+        char line[128];
+        auto length = std::snprintf(
+                line, sizeof(line), "GeneratedClass%zu::generatedMethod%zu - 0x%zx\n", i / 16, i % 16, 0x1000 + i * 0x40
+        );
+        file.write(line, length);
+    }
+}
+
+/// @brief Run the function a few times and get the median time in milliseconds.
+template <typename Function>
+static double measure(Function &&function, size_t &symbols) {
+    std::vector<double> times;
+    for (int i = 0; i < ITERATIONS; i++) {
+        auto start = std::chrono::steady_clock::now();
+        symbols = function().size();
+        times.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char **argv) {
+    auto directory = std::filesystem::temp_directory_path() / "bcl-parse-benchmark";
+    std::filesystem::create_directories(directory);
+
+    std::filesystem::path path;
+    if (argc > 1) {
+        path = argv[1];
+    } else {
+        path = directory / "synthetic.txt";
+        writeSyntheticFile(path);
+    }
+    auto cachePath = directory / "bindings.bin";
+    if (!SymbolTable::compileCache(path, cachePath)) {
+        std::fprintf(stderr, "Failed to read %s\n", path.string().c_str());
+        return 1;
+    }
+
+    std::printf("%s (%ju bytes), median of %d runs\n",
+                path.string().c_str(), static_cast<uintmax_t>(std::filesystem::file_size(path)), ITERATIONS);
+
+    size_t symbols = 0;
+    auto baseline = measure([&] { return parseLineByLine(path); }, symbols);
+    std::printf("  line by line:     %9.3f ms  %zu symbols\n", baseline, symbols);
+
+    auto parsed = measure([&] { return parseMapped(path); }, symbols);
+    std::printf("  SymbolTable::parse: %7.3f ms  %zu symbols  (%.1fx)\n", parsed, symbols, baseline / parsed);
+
+    auto cached = measure([&] { return loadCache(path, cachePath); }, symbols);
+    std::printf("  binary cache:     %9.3f ms  %zu symbols  (%.1fx)\n", cached, symbols, baseline / cached);
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return 0;
+}